@@ -0,0 +1,379 @@
+//
+// Benchmark senza grafica delle versioni di k-means: per ogni combinazione di backend, numero di punti,
+// numero di cluster, thread e schedule OpenMP esegue k-means più volte e scrive i risultati in CSV o JSON.
+//
+// Uso: kmeans_benchmark [--backends=seq,omp,soa,soa-par,soa-par-float] [--sizes=100000,1000000]
+//                       [--clusters=10,50] [--threads=1,2,4,8] [--schedules=static,dynamic,guided]
+//                       [--chunk=0] [--repeat=3] [--max-iter=150] [--seed=1] [--format=csv|json]
+//                       [--refresh=0] [--telemetry=file] [--counters=on] [--numa=on] [--output=file]
+//
+// --refresh=n > 0 usa l'aggiornamento incrementale delle somme (ricalcolo completo ogni n iterazioni)
+// nei backend seq, omp, soa e soa-par.
+// --telemetry=file scrive le statistiche di ogni iterazione dei backend seq e omp (JSON, o CSV se il file
+// termina in .csv); la misura stessa aggiunge un po' di tempo alle esecuzioni.
+// --counters=on legge i contatori hardware (perf_counters.h) durante k-means e aggiunge IPC, miss della
+// cache di ultimo livello, byte letti dalla memoria (miss * 64) e branch mispredetti per punto e iterazione.
+// Se i contatori non sono disponibili le colonne restano vuote (null in JSON).
+// --numa=on fissa i thread ai core divisi tra i nodi NUMA e, per il backend omp, copia i punti con la
+// stessa divisione statica del ciclo di assegnazione (numa_placement.h).
+// Con almeno blockedMinClusters cluster i backend seq e omp usano l'assegnazione a blocchi di
+// blocked_assign.h; per omp --chunk conta allora pannelli di panelPoints punti invece di singoli punti.
+//
+// I dati sono 10 cluster gaussiani generati in memoria; i centroidi iniziali vengono da k-means++
+// con lo stesso seme, quindi tutti i backend partono dagli stessi centroidi.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <omp.h>
+#include "kmeans.h"
+#include "lloyd.h"
+#include "soa_kmeans.h"
+#include "seeding.h"
+#include "dataset_generator.h"
+#include "telemetry.h"
+#include "perf_counters.h"
+#include "numa_placement.h"
+
+const std::vector<std::string> knownBackends{"seq", "omp", "soa", "soa-par", "soa-par-float"};
+
+struct benchConfig {
+    std::vector<std::string> backends = knownBackends;
+    std::vector<long long> sizes{100000, 1000000};
+    std::vector<int> clusters{10, 50};
+    std::vector<int> threads{1, 2, 4, 8};
+    std::vector<std::string> schedules{"static", "dynamic", "guided"};
+    int chunk = 0; // 0: dimensione predefinita di OpenMP per lo schedule
+    int repeat = 3;
+    int maxIter = 150;
+    unsigned long long seed = 1;
+    int refresh = 0;
+    std::string telemetry;
+    bool counters = false;
+    bool numa = false;
+    std::string format = "csv";
+    std::string output;
+};
+
+struct benchResult {
+    std::string backend;
+    std::string schedule;
+    int threads;
+    long long points;
+    int clusters;
+    int iterations;
+    double seconds; // mediana delle ripetizioni
+    double efficiency;
+    bool hasCounters;
+    perfTotals counters; // somma su tutte le ripetizioni
+    int totalIterations; // iterazioni di tutte le ripetizioni, per normalizzare i contatori
+};
+
+// Contatore diviso per punto e per iterazione
+double perPoint(const benchResult &r, double value) {
+    return value / (static_cast<double>(r.points) * r.totalIterations);
+}
+
+template<typename T>
+std::vector<T> parseList(const std::string &text) {
+    std::vector<T> values;
+    std::istringstream iss(text);
+    std::string item;
+    while (std::getline(iss, item, ',')) {
+        if (item.empty()) {
+            continue;
+        }
+        if constexpr (std::is_same_v<T, std::string>) {
+            values.push_back(item);
+        } else {
+            values.push_back(static_cast<T>(std::stoll(item)));
+        }
+    }
+    return values;
+}
+
+bool parseArguments(int argc, char *argv[], benchConfig &config) {
+    for (int a = 1; a < argc; a++) {
+        std::string arg = argv[a];
+        std::size_t eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 || eq == std::string::npos) {
+            std::cerr << "[Bench] Argomento non valido: " << arg << std::endl;
+            return false;
+        }
+        std::string key = arg.substr(2, eq - 2);
+        std::string value = arg.substr(eq + 1);
+        if (key == "backends") config.backends = parseList<std::string>(value);
+        else if (key == "sizes") config.sizes = parseList<long long>(value);
+        else if (key == "clusters") config.clusters = parseList<int>(value);
+        else if (key == "threads") config.threads = parseList<int>(value);
+        else if (key == "schedules") config.schedules = parseList<std::string>(value);
+        else if (key == "chunk") config.chunk = std::stoi(value);
+        else if (key == "repeat") config.repeat = std::max(1, std::stoi(value));
+        else if (key == "max-iter") config.maxIter = std::stoi(value);
+        else if (key == "seed") config.seed = std::stoull(value);
+        else if (key == "refresh") config.refresh = std::stoi(value);
+        else if (key == "telemetry") config.telemetry = value;
+        else if (key == "counters") config.counters = value == "on" || value == "1";
+        else if (key == "numa") config.numa = value == "on" || value == "1";
+        else if (key == "format") config.format = value;
+        else if (key == "output") config.output = value;
+        else {
+            std::cerr << "[Bench] Opzione sconosciuta: " << key << std::endl;
+            return false;
+        }
+    }
+    // Un nome sbagliato verrebbe misurato e riportato come un altro backend
+    for (const auto &name: config.backends) {
+        if (std::find(knownBackends.begin(), knownBackends.end(), name) == knownBackends.end()) {
+            std::cerr << "[Bench] Backend sconosciuto: " << name << std::endl;
+            return false;
+        }
+    }
+    if (config.format != "csv" && config.format != "json") {
+        std::cerr << "[Bench] Formato sconosciuto: " << config.format << " (csv o json)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool parseSchedule(const std::string &name, omp_sched_t &schedule) {
+    if (name == "static") schedule = omp_sched_static;
+    else if (name == "dynamic") schedule = omp_sched_dynamic;
+    else if (name == "guided") schedule = omp_sched_guided;
+    else if (name == "auto") schedule = omp_sched_auto;
+    else return false;
+    return true;
+}
+
+// Dati di una dimensione del dataset in tutti i layout usati dai backend
+struct benchDataset {
+    std::vector<double> x_values;
+    std::vector<double> y_values;
+    std::vector<float> x_float;
+    std::vector<float> y_float;
+    std::vector<point> points;
+};
+
+benchDataset makeDataset(long long numPoints, unsigned long long seed) {
+    benchDataset data;
+    const int dataClusters = 10;
+    generateDatasetPoints((numPoints + dataClusters - 1) / dataClusters, dataClusters, 200, 15, 700, 350, seed,
+                          data.x_values, data.y_values);
+    data.x_values.resize(numPoints);
+    data.y_values.resize(numPoints);
+    data.x_float.assign(data.x_values.begin(), data.x_values.end());
+    data.y_float.assign(data.y_values.begin(), data.y_values.end());
+    data.points.resize(numPoints);
+    for (long long j = 0; j < numPoints; j++) {
+        data.points[j] = point{data.x_values[j], data.y_values[j], -1};
+    }
+    return data;
+}
+
+// Una esecuzione di k-means con il backend richiesto: ritorna i secondi, iterations riceve le iterazioni.
+// Le copie dei dati di ingresso vengono fatte prima di far partire il cronometro
+double runOnce(const std::string &backend, omp_sched_t schedule, int chunk, const benchDataset &data,
+               const std::vector<point> &seeds, int maxIter, int refresh, telemetryLog *telemetry,
+               perfCounterSet *counters, bool numa, int &iterations) {
+    int numCluster = seeds.size();
+    std::vector<cluster> clusters(numCluster);
+    std::vector<double> x_centroids(numCluster), y_centroids(numCluster);
+    for (int c = 0; c < numCluster; c++) {
+        clusters[c].createCentroid(seeds[c]);
+        x_centroids[c] = seeds[c].x;
+        y_centroids[c] = seeds[c].y;
+    }
+    std::vector<point> points;
+    numaVector<point> placedPoints;
+    if (backend == "seq") {
+        points = data.points;
+    } else if (backend == "omp" && numa) {
+        firstTouchCopy<point>(data.points, placedPoints);
+    } else if (backend == "omp") {
+        placedPoints.assign(data.points.begin(), data.points.end());
+    }
+
+    if (counters) {
+        counters->start();
+    }
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    if (backend == "seq") {
+        kmeanSequential(clusters, points, maxIter, &iterations, refresh, telemetry);
+    } else if (backend == "omp") {
+        kmeanParallel(clusters, placedPoints, maxIter, &iterations, schedule, chunk, refresh, telemetry);
+    } else if (backend == "soa") {
+        kmeanSoA(x_centroids, y_centroids, data.x_values, data.y_values, numCluster, maxIter, &iterations, refresh);
+    } else if (backend == "soa-par") {
+        kmeanSoAParallel(x_centroids, y_centroids, data.x_values, data.y_values, numCluster, maxIter, &iterations,
+                         refresh);
+    } else if (backend == "soa-par-float") {
+        kmeanSoAParallelFloat(x_centroids, y_centroids, data.x_float, data.y_float, numCluster, maxIter,
+                              &iterations);
+    }
+    std::chrono::duration<double> elapsed_seconds = std::chrono::steady_clock::now() - start_time;
+    if (counters) {
+        counters->stop();
+    }
+    return elapsed_seconds.count();
+}
+
+void writeCSV(std::ostream &out, const std::vector<benchResult> &results) {
+    out << "backend,schedule,threads,points,clusters,iterations,seconds,seconds_per_iteration,points_per_second,"
+           "efficiency,ipc,llc_misses_per_point,bytes_per_point,branch_misses_per_point\n";
+    for (const auto &r: results) {
+        out << r.backend << "," << r.schedule << "," << r.threads << "," << r.points << "," << r.clusters << ","
+            << r.iterations << "," << r.seconds << "," << r.seconds / r.iterations << ","
+            << r.points * static_cast<double>(r.iterations) / r.seconds << "," << r.efficiency << ",";
+        if (r.hasCounters) {
+            out << r.counters.instructions / r.counters.cycles << "," << perPoint(r, r.counters.cacheMisses) << ","
+                << perPoint(r, r.counters.cacheMisses * 64) << "," << perPoint(r, r.counters.branchMisses);
+        } else {
+            out << ",,,";
+        }
+        out << "\n";
+    }
+}
+
+void writeJSON(std::ostream &out, const std::vector<benchResult> &results) {
+    out << "[\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const benchResult &r = results[i];
+        out << "  {\"backend\": \"" << r.backend << "\", \"schedule\": \"" << r.schedule
+            << "\", \"threads\": " << r.threads << ", \"points\": " << r.points << ", \"clusters\": " << r.clusters
+            << ", \"iterations\": " << r.iterations << ", \"seconds\": " << r.seconds
+            << ", \"seconds_per_iteration\": " << r.seconds / r.iterations
+            << ", \"points_per_second\": " << r.points * static_cast<double>(r.iterations) / r.seconds
+            << ", \"efficiency\": " << r.efficiency;
+        if (r.hasCounters) {
+            out << ", \"ipc\": " << r.counters.instructions / r.counters.cycles
+                << ", \"llc_misses_per_point\": " << perPoint(r, r.counters.cacheMisses)
+                << ", \"bytes_per_point\": " << perPoint(r, r.counters.cacheMisses * 64)
+                << ", \"branch_misses_per_point\": " << perPoint(r, r.counters.branchMisses);
+        } else {
+            out << ", \"ipc\": null, \"llc_misses_per_point\": null, \"bytes_per_point\": null"
+                   ", \"branch_misses_per_point\": null";
+        }
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+int main(int argc, char *argv[]) {
+    benchConfig config;
+    if (!parseArguments(argc, argv, config)) {
+        return 1;
+    }
+    for (const auto &name: config.schedules) {
+        omp_sched_t schedule;
+        if (!parseSchedule(name, schedule)) {
+            std::cerr << "[Bench] Schedule sconosciuto: " << name << std::endl;
+            return 1;
+        }
+    }
+    std::sort(config.threads.begin(), config.threads.end());
+
+    telemetryLog telemetry;
+    if (!config.telemetry.empty() && !telemetry.open(config.telemetry)) {
+        std::cerr << "[Bench] Errore nell'apertura del file " << config.telemetry << std::endl;
+        return 1;
+    }
+
+    std::vector<benchResult> results;
+    for (long long numPoints: config.sizes) {
+        std::cerr << "[Bench] Generazione di " << numPoints << " punti" << std::endl;
+        benchDataset data = makeDataset(numPoints, config.seed);
+
+        for (int numCluster: config.clusters) {
+            std::vector<point> seeds = seedKmeansPlusPlus(data.points, numCluster, config.seed);
+
+            for (const auto &backend: config.backends) {
+                bool threaded = backend == "omp" || backend == "soa-par" || backend == "soa-par-float";
+                std::vector<int> threadCounts = threaded ? config.threads : std::vector<int>{1};
+                // Lo schedule conta solo per il ciclo di assegnazione AoS, i backend SoA usano blocchi statici
+                std::vector<std::string> schedules = backend == "omp" ? config.schedules
+                                                                      : std::vector<std::string>{"static"};
+
+                for (const auto &scheduleName: schedules) {
+                    omp_sched_t schedule;
+                    parseSchedule(scheduleName, schedule);
+                    double baseWork = 0; // thread * tempo con il minor numero di thread
+
+                    for (int numThreads: threadCounts) {
+                        omp_set_num_threads(numThreads);
+                        if (config.numa && pinThreads().empty()) {
+                            std::cerr << "[Bench] Impossibile fissare i thread ai core" << std::endl;
+                        }
+                        // I contatori vengono aperti sui thread che eseguiranno k-means
+                        perfCounterSet counters;
+                        if (config.counters && !counters.open(numThreads)) {
+                            std::cerr << "[Bench] Contatori hardware non disponibili (" << counters.lastError()
+                                      << "), si continua senza" << std::endl;
+                            config.counters = false;
+                        }
+                        perfTotals counterTotals;
+                        int totalIterations = 0;
+                        std::vector<double> times;
+                        int iterations = 0;
+                        for (int r = 0; r < config.repeat; r++) {
+                            // I messaggi dei singoli backend vengono scartati durante la misura
+                            telemetry.setRun(backend + "/" + scheduleName + "/" + std::to_string(numThreads) + "/" +
+                                             std::to_string(numPoints) + "/" + std::to_string(numCluster) + "/" +
+                                             std::to_string(r));
+                            std::streambuf *coutBuffer = std::cout.rdbuf(nullptr);
+                            times.push_back(runOnce(backend, schedule, config.chunk, data, seeds, config.maxIter,
+                                                    config.refresh,
+                                                    config.telemetry.empty() ? nullptr : &telemetry,
+                                                    counters.isOpen() ? &counters : nullptr, config.numa,
+                                                    iterations));
+                            std::cout.rdbuf(coutBuffer);
+                            std::cout.clear();
+                            if (counters.isOpen()) {
+                                perfTotals run = counters.read();
+                                counterTotals.cycles += run.cycles;
+                                counterTotals.instructions += run.instructions;
+                                counterTotals.cacheMisses += run.cacheMisses;
+                                counterTotals.branchMisses += run.branchMisses;
+                            }
+                            totalIterations += iterations;
+                        }
+                        std::sort(times.begin(), times.end());
+                        double seconds = times[times.size() / 2];
+                        if (baseWork == 0) {
+                            baseWork = seconds * numThreads;
+                        }
+
+                        results.push_back({backend, scheduleName, numThreads, numPoints, numCluster, iterations,
+                                           seconds, baseWork / (seconds * numThreads),
+                                           counters.isOpen() && counterTotals.cycles > 0, counterTotals,
+                                           totalIterations});
+                        std::cerr << "[Bench] " << backend << " " << scheduleName << " thread=" << numThreads
+                                  << " N=" << numPoints << " K=" << numCluster << ": " << seconds << " s, "
+                                  << iterations << " iterazioni" << std::endl;
+                    }
+                }
+            }
+        }
+    }
+
+    std::ofstream outFile;
+    if (!config.output.empty()) {
+        outFile.open(config.output);
+        if (!outFile) {
+            std::cerr << "[Bench] Errore nell'apertura del file " << config.output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream &out = config.output.empty() ? std::cout : outFile;
+    if (config.format == "json") {
+        writeJSON(out, results);
+    } else {
+        writeCSV(out, results);
+    }
+    return 0;
+}
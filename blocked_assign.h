@@ -0,0 +1,181 @@
+//
+// Assegnazione a blocchi per K grande. I centroidi vengono copiati una volta per iterazione in un buffer
+// SoA contiguo e allineato (x, y e ‖c‖²) e la distanza viene calcolata come ‖x‖² − 2x·c + ‖c‖²:
+// per scegliere il centroide basta ‖c‖² − 2x·c, due moltiplicazioni e due somme per coppia.
+// Il ciclo è diviso in pannelli di punti (stato dei punti in L2) e blocchi di centroidi (in L1):
+// ogni blocco di centroidi viene usato da tutti i punti del pannello prima di passare al successivo,
+// quindi con migliaia di centroidi il costo resta nel calcolo e non nelle letture dalla memoria.
+// Il ciclo interno scorre i punti con il centroide fisso ed è vettorizzato come i kernel SoA.
+//
+
+#ifndef KMEANS_BLOCKED_ASSIGN_H
+#define KMEANS_BLOCKED_ASSIGN_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+#include "kmeans.h"
+#include "soa_kernel.h"
+
+// Sotto questa soglia il ciclo semplice sui centroidi è già veloce e non vale la copia nel buffer
+const int blockedMinClusters = 32;
+// Punti per pannello: coordinate, distanza minima e indice occupano circa 112 KB (L2)
+const std::size_t panelPoints = 4096;
+// Punti per tile: il ciclo interno lavora su 256 punti (7 KB) insieme a un blocco di centroidi in L1
+const std::size_t tilePoints = 256;
+// Centroidi per blocco: 512 centroidi occupano 12 KB
+const int blockCentroids = 512;
+
+// Centroidi in SoA su linee di cache proprie
+class centroidBuffer {
+
+private:
+    struct alignedDelete {
+        void operator()(double *p) const {
+            ::operator delete[](p, std::align_val_t(64));
+        }
+    };
+
+    std::unique_ptr<double[], alignedDelete> storage;
+    int capacity = 0;
+
+public:
+    int numCluster = 0;
+    double *x = nullptr;
+    double *y = nullptr;
+    double *norm = nullptr; // ‖c‖²
+
+    // Copia i centroidi dei cluster nel buffer
+    void pack(std::vector<cluster> &clusters) {
+        int k = static_cast<int>(clusters.size());
+        if (k > capacity) {
+            // Ogni colonna inizia su una linea di cache (8 double)
+            capacity = (k + 7) / 8 * 8;
+            storage.reset(new(std::align_val_t(64)) double[3 * capacity]);
+            x = storage.get();
+            y = x + capacity;
+            norm = y + capacity;
+        }
+        numCluster = k;
+        for (int c = 0; c < k; c++) {
+            point centroid = clusters[c].getCentroid();
+            x[c] = centroid.x;
+            y[c] = centroid.y;
+            norm[c] = centroid.x * centroid.x + centroid.y * centroid.y;
+        }
+    }
+};
+
+#if defined(__GNUC__)
+#define KMEANS_ALWAYS_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define KMEANS_ALWAYS_INLINE __forceinline
+#else
+#define KMEANS_ALWAYS_INLINE inline
+#endif
+
+// Cicli sui blocchi di un pannello: best e bestIdx ricevono distanza espansa (senza ‖x‖²) e indice.
+// Anche l'indice è un double, come nei kernel SoA: tutte le lane del ciclo interno hanno la stessa larghezza.
+// Il corpo viene copiato nelle varianti qui sotto e compilato per il set di istruzioni di ognuna
+KMEANS_ALWAYS_INLINE void panelTiles(const double *px, const double *py, std::size_t n,
+                                     const centroidBuffer &buffer, double *best, double *bestIdx) {
+    for (int c0 = 0; c0 < buffer.numCluster; c0 += blockCentroids) {
+        int c1 = std::min(buffer.numCluster, c0 + blockCentroids);
+        for (std::size_t t0 = 0; t0 < n; t0 += tilePoints) {
+            std::size_t t1 = std::min(n, t0 + tilePoints);
+            for (int k = c0; k < c1; k++) {
+                double cx = -2 * buffer.x[k];
+                double cy = -2 * buffer.y[k];
+                double cn = buffer.norm[k];
+                double idx = k;
+#pragma omp simd
+                for (std::size_t j = t0; j < t1; j++) {
+                    double d = cn + px[j] * cx + py[j] * cy;
+                    bool lt = d < best[j];
+                    best[j] = lt ? d : best[j];
+                    bestIdx[j] = lt ? idx : bestIdx[j];
+                }
+            }
+        }
+    }
+}
+
+typedef void (*panelKernel)(const double *px, const double *py, std::size_t n, const centroidBuffer &buffer,
+                            double *best, double *bestIdx);
+
+inline void panelBaseline(const double *px, const double *py, std::size_t n, const centroidBuffer &buffer,
+                          double *best, double *bestIdx) {
+    panelTiles(px, py, n, buffer, best, bestIdx);
+}
+
+#if defined(KMEANS_X86) && defined(__GNUC__)
+KMEANS_TARGET("avx2,fma")
+inline void panelAVX2(const double *px, const double *py, std::size_t n, const centroidBuffer &buffer,
+                      double *best, double *bestIdx) {
+    panelTiles(px, py, n, buffer, best, bestIdx);
+}
+
+KMEANS_TARGET("avx512f")
+inline void panelAVX512(const double *px, const double *py, std::size_t n, const centroidBuffer &buffer,
+                        double *best, double *bestIdx) {
+    panelTiles(px, py, n, buffer, best, bestIdx);
+}
+#endif
+
+// Sceglie la variante migliore supportata dalla CPU. Con MSVC le varianti non hanno attributi di target,
+// quindi resta quella compilata con i flag del progetto
+inline panelKernel selectPanelKernel() {
+#if defined(KMEANS_X86) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return panelAVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return panelAVX2;
+    }
+#endif
+    return panelBaseline;
+}
+
+// Memoria di lavoro di un pannello (circa 200 KB). Va allocata una volta per esecuzione, una per thread,
+// e passata a ogni assegnazione: sullo stack o allocata a ogni pannello costerebbe a ogni iterazione.
+// nearest e nearestDist contengono il risultato dell'ultimo assignPanel
+struct alignas(64) panelScratch {
+    double px[panelPoints];
+    double py[panelPoints];
+    double best[panelPoints];
+    double bestIdx[panelPoints];
+    double nearestDist[panelPoints];
+    int nearest[panelPoints];
+};
+
+// Assegna i punti [0, n) di un pannello (n <= panelPoints) al centroide più vicino: scratch.nearest riceve
+// l'indice e scratch.nearestDist la distanza al quadrato. La distanza espansa perde qualche cifra rispetto a
+// quella diretta quando i punti sono lontani dall'origine, quindi a pari distanza il centroide scelto
+// può essere diverso da quello del ciclo semplice
+inline void assignPanel(const double *px, const double *py, std::size_t n, const centroidBuffer &buffer,
+                        panelScratch &scratch) {
+    static const panelKernel kernel = selectPanelKernel();
+    std::fill_n(scratch.best, n, INFINITY);
+    std::fill_n(scratch.bestIdx, n, 0.0);
+    kernel(px, py, n, buffer, scratch.best, scratch.bestIdx);
+
+    for (std::size_t j = 0; j < n; j++) {
+        scratch.nearest[j] = static_cast<int>(scratch.bestIdx[j]);
+        scratch.nearestDist[j] = std::max(0.0, scratch.best[j] + px[j] * px[j] + py[j] * py[j]);
+    }
+}
+
+// Pannello di punti AoS: le coordinate vengono copiate in SoA in scratch prima dell'assegnazione
+inline void assignPanel(const point *points, std::size_t n, const centroidBuffer &buffer, panelScratch &scratch) {
+    for (std::size_t j = 0; j < n; j++) {
+        scratch.px[j] = points[j].x;
+        scratch.py[j] = points[j].y;
+    }
+    assignPanel(scratch.px, scratch.py, n, buffer, scratch);
+}
+
+#endif // KMEANS_BLOCKED_ASSIGN_H
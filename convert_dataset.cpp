@@ -0,0 +1,113 @@
+//
+// Conversione del dataset dal formato testo (una riga "x y" per punto) al formato binario
+// a colonne di dataset_binary.h. Il file viene mappato e convertito a blocchi, quindi può superare la memoria.
+//
+// Uso: convert_dataset [input] [output] [float64|float32]
+//
+
+#include <iostream>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "dataset_binary.h"
+#include "dataset_parser.h"
+#include "mapped_file.h"
+
+// Destinazione che conta solo i punti validi, per la prima passata: l'ultimo resize del parser
+// riceve il numero di righe convertite
+struct countStore {
+    std::size_t points = 0;
+
+    int dimension() const {
+        return 2;
+    }
+
+    void resize(std::size_t n) {
+        points = n;
+    }
+
+    void set(std::size_t, const double *) {}
+
+    void move(std::size_t, std::size_t, std::size_t) {}
+};
+
+// Blocco di byte da begin lungo circa chunkBytes, tagliato dopo l'ultimo '\n' (o alla fine del file)
+std::size_t chunkEnd(const mappedFile &file, std::size_t begin, std::size_t chunkBytes) {
+    if (file.size() - begin <= chunkBytes) {
+        return file.size();
+    }
+    std::size_t end = begin + chunkBytes;
+    const void *newline = std::memchr(file.data() + end, '\n', file.size() - end);
+    return newline ? static_cast<const char *>(newline) - file.data() + 1 : file.size();
+}
+
+int main(int argc, char *argv[]) {
+    std::string inPath = argc > 1 ? argv[1] : "../dataset/dataset.txt";
+    std::string outPath = argc > 2 ? argv[2] : "../dataset/dataset.bin";
+    bool single = argc > 3 && std::string(argv[3]) == "float32";
+    const std::size_t chunkBytes = 64 << 20;
+
+    std::cout << "[Conv] Conversione " << inPath << " -> " << outPath << std::endl;
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    // Il testo viene letto con lo stesso parser dei programmi di k-means (dataset_parser.h), a blocchi
+    // di byte: le righe che il parser scarta non finiscono nel file binario
+    // Dimensione e data del testo vengono lette prima della conversione e salvate nell'intestazione:
+    // se il testo cambia dopo, i programmi smettono di preferire il file binario
+    datasetSource source;
+    mappedFile inFile;
+    if (!readDatasetSource(inPath, source) || !inFile.open(inPath)) {
+        std::cerr << "[Conv] Errore nell'apertura del file" << std::endl;
+        return 1;
+    }
+
+    // Prima passata: numero di punti, che serve per la posizione della colonna y
+    std::uint64_t count = 0;
+    for (std::size_t begin = 0; begin < inFile.size();) {
+        std::size_t end = chunkEnd(inFile, begin, chunkBytes);
+        countStore counter;
+        parseDatasetBytes(inFile.data() + begin, end - begin, counter);
+        count += counter.points;
+        begin = end;
+    }
+
+    binaryDatasetWriter writer;
+    if (!writer.open(outPath, count, single ? datasetFloat32 : datasetFloat64, source)) {
+        std::cerr << "[Conv] Errore nell'apertura del file di output" << std::endl;
+        return 1;
+    }
+
+    // Seconda passata: i punti vengono scritti a blocchi nelle due colonne, nella precisione scelta
+    std::vector<double> x_vec;
+    std::vector<double> y_vec;
+    std::vector<float> x_single;
+    std::vector<float> y_single;
+    soaStore store{x_vec, y_vec};
+    std::uint64_t written = 0;
+    bool ok = true;
+    for (std::size_t begin = 0; begin < inFile.size() && ok;) {
+        std::size_t end = chunkEnd(inFile, begin, chunkBytes);
+        parseDatasetBytes(inFile.data() + begin, end - begin, store);
+        if (written + x_vec.size() > count) {
+            ok = false;
+        } else if (!single) {
+            ok = writer.write(written, x_vec.data(), y_vec.data(), x_vec.size());
+        } else {
+            x_single.assign(x_vec.begin(), x_vec.end());
+            y_single.assign(y_vec.begin(), y_vec.end());
+            ok = writer.write(written, x_single.data(), y_single.data(), x_single.size());
+        }
+        written += x_vec.size();
+        begin = end;
+    }
+
+    if (!writer.close() || !ok || written != count) {
+        std::cerr << "[Conv] Errore nella scrittura del file di output" << std::endl;
+        return 1;
+    }
+
+    std::chrono::duration<double> elapsed_seconds = std::chrono::steady_clock::now() - start_time;
+    std::cout << "[Conv] Punti convertiti: " << written << " in " << elapsed_seconds.count() << " secondi" << std::endl;
+    return 0;
+}
@@ -0,0 +1,248 @@
+//
+// Formato binario a colonne per il dataset: intestazione da 64 byte seguita dalle colonne x e y
+// contigue. Il file viene mappato in memoria, quindi le colonne si usano senza copie.
+//
+
+#ifndef KMEANS_DATASET_BINARY_H
+#define KMEANS_DATASET_BINARY_H
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "dataset_parser.h"
+#include "mapped_file.h"
+
+const char datasetMagic[8] = {'K', 'M', 'E', 'A', 'N', 'S', 'D', 'B'};
+const std::uint32_t datasetVersion = 1;
+const std::uint64_t datasetAlignment = 64; // ogni colonna inizia su una linea di cache
+
+enum datasetType : std::uint32_t {
+    datasetFloat64 = 1,
+    datasetFloat32 = 2
+};
+
+// Intestazione del file, little-endian come le macchine su cui gira il programma
+struct datasetHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t dtype;
+    std::uint64_t count;         // numero di punti
+    std::uint32_t dimension;     // numero di colonne
+    std::uint32_t reserved;
+    std::uint64_t dataOffset;    // byte dall'inizio del file alla prima colonna
+    std::uint64_t columnStride;  // byte tra l'inizio di una colonna e la successiva
+    std::uint64_t sourceSize;    // dimensione del file di testo convertito, 0 se generato direttamente
+    std::int64_t sourceTime;     // data di modifica del file di testo convertito, 0 se generato direttamente
+};
+static_assert(sizeof(datasetHeader) == 64, "L'intestazione deve occupare 64 byte");
+
+// Dimensione e data di modifica del file di testo da cui deriva un file binario
+struct datasetSource {
+    std::uint64_t size = 0;
+    std::int64_t time = 0;
+};
+
+inline bool readDatasetSource(const std::string &textPath, datasetSource &source) {
+    std::error_code ec;
+    std::uintmax_t size = std::filesystem::file_size(textPath, ec);
+    if (ec) {
+        return false;
+    }
+    std::filesystem::file_time_type time = std::filesystem::last_write_time(textPath, ec);
+    if (ec) {
+        return false;
+    }
+    source.size = size;
+    source.time = time.time_since_epoch().count();
+    return true;
+}
+
+// Il file binario va usato al posto del dataset di testo solo se convert_dataset lo ha prodotto
+// da quel file, nella versione attuale: la data di modifica da sola non basta, perché un .bin generato
+// o copiato a parte può essere più recente del testo pur contenendo altri punti
+inline bool binaryDatasetIsCurrent(const std::string &binaryPath, const std::string &textPath) {
+    std::error_code ec;
+    if (!std::filesystem::exists(binaryPath, ec)) {
+        return false;
+    }
+    if (!std::filesystem::exists(textPath, ec)) {
+        return true;
+    }
+    datasetSource source;
+    if (!readDatasetSource(textPath, source)) {
+        return false;
+    }
+    std::ifstream inFile(binaryPath, std::ios::binary);
+    datasetHeader header{};
+    if (!inFile.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, datasetMagic, sizeof(datasetMagic)) != 0) {
+        return false;
+    }
+    return header.sourceTime != 0 && header.sourceSize == source.size && header.sourceTime == source.time;
+}
+
+inline std::size_t datasetTypeSize(std::uint32_t dtype) {
+    return dtype == datasetFloat32 ? sizeof(float) : sizeof(double);
+}
+
+inline datasetHeader makeDatasetHeader(std::uint64_t count, std::uint32_t dimension, std::uint32_t dtype) {
+    datasetHeader header{};
+    std::memcpy(header.magic, datasetMagic, sizeof(datasetMagic));
+    header.version = datasetVersion;
+    header.dtype = dtype;
+    header.count = count;
+    header.dimension = dimension;
+    header.dataOffset = sizeof(datasetHeader);
+    std::uint64_t bytes = count * datasetTypeSize(dtype);
+    header.columnStride = (bytes + datasetAlignment - 1) / datasetAlignment * datasetAlignment;
+    return header;
+}
+
+// Scrittura a blocchi del formato binario (double o float): i punti possono arrivare in più parti,
+// quindi non serve tenere tutto il dataset in memoria per convertirlo o generarlo
+class binaryDatasetWriter {
+
+private:
+    std::ofstream outFile;
+    datasetHeader header{};
+
+public:
+
+    // source identifica il file di testo convertito; resta vuoto per i dataset generati direttamente
+    bool open(const std::string &path, std::uint64_t count, std::uint32_t dtype = datasetFloat64,
+              datasetSource source = {}) {
+        outFile.open(path, std::ios::binary | std::ios::trunc);
+        if (!outFile) {
+            return false;
+        }
+        header = makeDatasetHeader(count, 2, dtype);
+        header.sourceSize = source.size;
+        header.sourceTime = source.time;
+        outFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        // Lunghezza finale del file, comprese le colonne
+        outFile.seekp(header.dataOffset + 2 * header.columnStride - 1);
+        outFile.put(0);
+        return static_cast<bool>(outFile);
+    }
+
+    // Scrive i punti [first, first + n) nelle due colonne. T deve corrispondere al tipo scelto in open
+    template<typename T>
+    bool write(std::uint64_t first, const T *x, const T *y, std::size_t n) {
+        if (sizeof(T) != datasetTypeSize(header.dtype)) {
+            return false;
+        }
+        outFile.seekp(header.dataOffset + first * sizeof(T));
+        outFile.write(reinterpret_cast<const char *>(x), n * sizeof(T));
+        outFile.seekp(header.dataOffset + header.columnStride + first * sizeof(T));
+        outFile.write(reinterpret_cast<const char *>(y), n * sizeof(T));
+        return static_cast<bool>(outFile);
+    }
+
+    bool close() {
+        outFile.close();
+        return !outFile.fail();
+    }
+};
+
+inline bool writeBinaryDataset(const std::string &path, const std::vector<double> &x_values,
+                               const std::vector<double> &y_values) {
+    binaryDatasetWriter writer;
+    return writer.open(path, x_values.size()) &&
+           writer.write(0, x_values.data(), y_values.data(), x_values.size()) &&
+           writer.close();
+}
+
+// Dataset binario mappato in memoria in sola lettura. Le colonne puntano direttamente alle
+// pagine del file: il caricamento costa una mmap, i dati vengono letti dal disco al primo accesso
+class mappedDataset {
+
+private:
+    mappedFile file;
+    datasetHeader header{};
+
+    bool validHeader() const {
+        if (file.size() < sizeof(datasetHeader)) {
+            return false;
+        }
+        const datasetHeader &h = *reinterpret_cast<const datasetHeader *>(file.data());
+        if (std::memcmp(h.magic, datasetMagic, sizeof(datasetMagic)) != 0 || h.version != datasetVersion ||
+            (h.dtype != datasetFloat64 && h.dtype != datasetFloat32) || h.dataOffset % datasetAlignment != 0) {
+            return false;
+        }
+        return h.dataOffset + h.columnStride * h.dimension <= file.size() &&
+               h.count * datasetTypeSize(h.dtype) <= h.columnStride;
+    }
+
+public:
+
+    // Ritorna false se il file non esiste o non è nel formato atteso
+    bool open(const std::string &path) {
+        if (!file.open(path)) {
+            return false;
+        }
+        if (!validHeader()) {
+            file.close();
+            return false;
+        }
+        header = *reinterpret_cast<const datasetHeader *>(file.data());
+        return true;
+    }
+
+    std::size_t size() const {
+        return header.count;
+    }
+
+    std::uint32_t dimension() const {
+        return header.dimension;
+    }
+
+    std::uint32_t type() const {
+        return header.dtype;
+    }
+
+    // Colonna d del dataset (0 = x, 1 = y), con d < dimension()
+    template<typename T = double>
+    std::span<const T> column(int d) const {
+        assert(d >= 0 && static_cast<std::uint32_t>(d) < header.dimension);
+        const char *start = file.data() + header.dataOffset + d * header.columnStride;
+        return {reinterpret_cast<const T *>(start), static_cast<std::size_t>(header.count)};
+    }
+};
+
+// Colonne x e y di un dataset binario o di testo, per i programmi che accettano entrambi i formati.
+// Le colonne double del file binario restano mappate, quelle float e il testo vengono letti in memoria
+struct datasetColumns {
+    mappedDataset binary;
+    std::vector<double> x_values, y_values;
+    std::span<const double> x, y;
+
+    // Ritorna false se il file non può essere letto, non contiene punti o non è bidimensionale
+    bool load(const std::string &path) {
+        if (binary.open(path)) {
+            if (binary.dimension() != 2) {
+                return false;
+            }
+            if (binary.type() == datasetFloat64) {
+                x = binary.column(0);
+                y = binary.column(1);
+                return !x.empty();
+            }
+            std::span<const float> xf = binary.column<float>(0), yf = binary.column<float>(1);
+            x_values.assign(xf.begin(), xf.end());
+            y_values.assign(yf.begin(), yf.end());
+        } else if (!parseDatasetSoA(path, x_values, y_values)) {
+            return false;
+        }
+        x = x_values;
+        y = y_values;
+        return !x.empty();
+    }
+};
+
+#endif // KMEANS_DATASET_BINARY_H
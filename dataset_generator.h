@@ -0,0 +1,156 @@
+//
+// Generazione parallela del dataset sintetico: cluster gaussiani attorno a centri casuali,
+// scritti in testo o direttamente nel formato binario di dataset_binary.h.
+//
+
+#ifndef KMEANS_DATASET_GENERATOR_H
+#define KMEANS_DATASET_GENERATOR_H
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "dataset_binary.h"
+
+// I punti vengono generati a blocchi di dimensione fissa e ogni blocco ha il proprio generatore,
+// inizializzato da (seme, indice del blocco): il file non dipende dal numero di thread
+const long long generatorBlockSize = 1 << 16;
+
+// Centri dei cluster, generati in sequenza dal seme e distanti almeno centerDist tra loro
+inline std::vector<std::pair<double, double>> generateCenters(int numClusters, int centerDist, int rangeX, int rangeY,
+                                                              unsigned long long seed) {
+    std::mt19937_64 gen(seed);
+    std::uniform_real_distribution<double> cenX(-rangeX, rangeX);
+    std::uniform_real_distribution<double> cenY(-rangeY, rangeY);
+
+    std::vector<std::pair<double, double>> centers;
+    for (int i = 0; i < numClusters; ++i) {
+        double x, y;
+        bool validPos = false;
+        while (!validPos) {
+            x = cenX(gen);
+            y = cenY(gen);
+            validPos = true;
+            for (const auto &existing: centers) {
+                if (std::sqrt(std::pow(existing.first - x, 2) + std::pow(existing.second - y, 2)) < centerDist) {
+                    validPos = false;
+                    break;
+                }
+            }
+        }
+        centers.emplace_back(x, y);
+    }
+    return centers;
+}
+
+// Genera in xs e ys i punti del blocco b (al più generatorBlockSize, senza superare total).
+// Il generatore dipende solo dal seme e dall'indice del blocco
+inline void generateBlock(const std::vector<std::pair<double, double>> &centers, long long numPointsPerCluster,
+                          int stdDev, unsigned long long seed, long long b, long long total, double *xs, double *ys) {
+    long long first = b * generatorBlockSize;
+    long long last = std::min(first + generatorBlockSize, total);
+    std::seed_seq seq{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32),
+                      static_cast<std::uint32_t>(b), static_cast<std::uint32_t>(b >> 32)};
+    std::mt19937_64 gen(seq);
+    std::normal_distribution<double> noise(0.0, stdDev);
+    for (long long i = first; i < last; i++) {
+        const std::pair<double, double> &center = centers[i / numPointsPerCluster];
+        xs[i - first] = center.first + noise(gen);
+        ys[i - first] = center.second + noise(gen);
+    }
+}
+
+// Aggiunge "x y\n" al buffer con lo stesso formato di std::ostream (6 cifre significative)
+inline void appendPoint(std::string &buffer, double x, double y) {
+    char text[64];
+    char *end = std::to_chars(text, text + sizeof(text), x, std::chars_format::general, 6).ptr;
+    *end++ = ' ';
+    end = std::to_chars(end, text + sizeof(text), y, std::chars_format::general, 6).ptr;
+    *end++ = '\n';
+    buffer.append(text, end);
+}
+
+// Genera numClusters * numPointsPerCluster punti (cluster dopo cluster, come la versione sequenziale).
+// I blocchi vengono prodotti in parallelo e scritti in ordine, senza flush per riga
+inline bool generateDatasetFile(const std::string &path, long long numPointsPerCluster, int numClusters,
+                                int centerDist, int stdDev, int rangeX, int rangeY, unsigned long long seed,
+                                bool binary) {
+    std::vector<std::pair<double, double>> centers = generateCenters(numClusters, centerDist, rangeX, rangeY, seed);
+    long long total = numPointsPerCluster * numClusters;
+    long long numBlocks = (total + generatorBlockSize - 1) / generatorBlockSize;
+
+    std::ofstream outFile;
+    binaryDatasetWriter writer;
+    if (binary) {
+        if (!writer.open(path, total)) {
+            return false;
+        }
+    } else {
+        outFile.open(path, std::ios::binary | std::ios::trunc);
+        if (!outFile) {
+            return false;
+        }
+    }
+
+    bool ok = true;
+#pragma omp parallel
+    {
+        std::vector<double> xs(generatorBlockSize);
+        std::vector<double> ys(generatorBlockSize);
+        std::string text;
+        text.reserve(generatorBlockSize * 28);
+
+#pragma omp for ordered schedule(static, 1)
+        for (long long b = 0; b < numBlocks; b++) {
+            long long first = b * generatorBlockSize;
+            long long last = std::min(first + generatorBlockSize, total);
+
+            generateBlock(centers, numPointsPerCluster, stdDev, seed, b, total, xs.data(), ys.data());
+            if (!binary) {
+                text.clear();
+                for (long long i = 0; i < last - first; i++) {
+                    appendPoint(text, xs[i], ys[i]);
+                }
+            }
+
+#pragma omp ordered
+            {
+                if (binary) {
+                    ok = writer.write(first, xs.data(), ys.data(), last - first) && ok;
+                } else {
+                    ok = static_cast<bool>(outFile.write(text.data(), text.size())) && ok;
+                }
+            }
+        }
+    }
+
+    if (binary) {
+        return writer.close() && ok;
+    }
+    outFile.close();
+    return !outFile.fail() && ok;
+}
+
+// Stesso dataset di generateDatasetFile, generato direttamente in memoria (layout SoA)
+inline void generateDatasetPoints(long long numPointsPerCluster, int numClusters, int centerDist, int stdDev,
+                                  int rangeX, int rangeY, unsigned long long seed,
+                                  std::vector<double> &x_values, std::vector<double> &y_values) {
+    std::vector<std::pair<double, double>> centers = generateCenters(numClusters, centerDist, rangeX, rangeY, seed);
+    long long total = numPointsPerCluster * numClusters;
+    long long numBlocks = (total + generatorBlockSize - 1) / generatorBlockSize;
+    x_values.resize(total);
+    y_values.resize(total);
+#pragma omp parallel for schedule(static)
+    for (long long b = 0; b < numBlocks; b++) {
+        generateBlock(centers, numPointsPerCluster, stdDev, seed, b, total,
+                      x_values.data() + b * generatorBlockSize, y_values.data() + b * generatorBlockSize);
+    }
+}
+
+#endif // KMEANS_DATASET_GENERATOR_H
@@ -0,0 +1,276 @@
+//
+// Lettura parallela del dataset di testo: il file viene mappato in memoria, diviso in blocchi
+// sui confini di riga e ogni blocco viene convertito con std::from_chars direttamente nei
+// vettori di destinazione, già allocati. Usato da tutte le versioni di k-means.
+//
+
+#ifndef KMEANS_DATASET_PARSER_H
+#define KMEANS_DATASET_PARSER_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Legge un double saltando spazi e tabulazioni iniziali. Ritorna il carattere dopo il numero,
+// nullptr se la riga non contiene un numero valido
+inline const char *parseNumber(const char *p, const char *end, double &value) {
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        p++;
+    }
+    std::from_chars_result result = std::from_chars(p, end, value);
+    return result.ec == std::errc() ? result.ptr : nullptr;
+}
+
+// Numero massimo di coordinate per riga
+const int maxParsedDimension = 64;
+
+// Converte le righe di [begin, end), ognuna con store.dimension() coordinate, salvando il punto i-esimo
+// del blocco in store.set(offset + i, valori). Le righe vuote o non valide (ad esempio l'ultima riga vuota)
+// vengono saltate. Ritorna i punti letti (0 se store.dimension() supera maxParsedDimension)
+template<typename Store>
+std::size_t parseChunk(const char *begin, const char *end, std::size_t offset, Store &store) {
+    const int dim = store.dimension();
+    if (dim <= 0 || dim > maxParsedDimension) {
+        return 0;
+    }
+    std::size_t n = 0;
+    const char *p = begin;
+    while (p < end) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        double values[maxParsedDimension];
+        const char *q = p;
+        for (int d = 0; d < dim && q; d++) {
+            q = parseNumber(q, lineEnd, values[d]);
+        }
+        if (q) {
+            store.set(offset + n, values);
+            n++;
+        }
+        p = lineEnd + 1;
+    }
+    return n;
+}
+
+// Parser generico su byte già in memoria: store deve offrire dimension(), resize(n), set(i, valori)
+// e move(dst, src, n).
+// 1) i byte vengono diviso in blocchi che iniziano dopo un '\n';
+// 2) in parallelo si contano le righe di ogni blocco, che danno la posizione di partenza di ognuno;
+// 3) in parallelo ogni blocco viene convertito nella propria parte dei vettori;
+// 4) se alcune righe non erano valide i blocchi vengono compattati
+template<typename Store>
+void parseDatasetBytes(const char *data, std::size_t size, Store &store) {
+    int numThreads = 1;
+#ifdef _OPENMP
+    numThreads = omp_get_max_threads();
+#endif
+    // Più blocchi che thread per bilanciare il carico, ma non più piccoli di 1 MB
+    const std::size_t minChunk = 1 << 20;
+    int numChunks = static_cast<int>(std::max<std::size_t>(1, std::min<std::size_t>(size / minChunk, numThreads * 4)));
+
+    std::vector<std::size_t> starts(numChunks + 1);
+    starts[0] = 0;
+    starts[numChunks] = size;
+    for (int c = 1; c < numChunks; c++) {
+        std::size_t s = std::max(starts[c - 1], c * (size / numChunks));
+        const void *newline = s < size ? std::memchr(data + s, '\n', size - s) : nullptr;
+        starts[c] = newline ? static_cast<const char *>(newline) - data + 1 : size;
+    }
+
+    // Righe per blocco (l'ultima riga può non avere '\n')
+    std::vector<std::size_t> lines(numChunks);
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int c = 0; c < numChunks; c++) {
+        const char *begin = data + starts[c];
+        const char *end = data + starts[c + 1];
+        lines[c] = std::count(begin, end, '\n') + (end > begin && end[-1] != '\n' ? 1 : 0);
+    }
+
+    std::vector<std::size_t> offsets(numChunks + 1, 0);
+    for (int c = 0; c < numChunks; c++) {
+        offsets[c + 1] = offsets[c] + lines[c];
+    }
+    store.resize(offsets[numChunks]);
+
+    std::vector<std::size_t> parsed(numChunks);
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int c = 0; c < numChunks; c++) {
+        parsed[c] = parseChunk(data + starts[c], data + starts[c + 1], offsets[c], store);
+    }
+
+    std::size_t total = 0;
+    for (int c = 0; c < numChunks; c++) {
+        if (total != offsets[c]) {
+            store.move(total, offsets[c], parsed[c]);
+        }
+        total += parsed[c];
+    }
+    store.resize(total);
+}
+
+// Legge tutto il file path in store
+template<typename Store>
+bool parseDatasetFile(const std::string &path, Store &store) {
+    mappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    parseDatasetBytes(file.data(), file.size(), store);
+    return true;
+}
+
+// Primo byte della parte shard di numShards del file: ogni riga appartiene alla parte in cui inizia
+inline std::size_t shardBoundary(const char *data, std::size_t size, int shard, int numShards) {
+    if (shard <= 0) {
+        return 0;
+    }
+    if (shard >= numShards) {
+        return size;
+    }
+    std::size_t b = static_cast<std::size_t>(static_cast<double>(size) * shard / numShards);
+    // Con meno byte che parti il confine cade all'inizio del file: le parti precedenti restano vuote
+    if (b == 0) {
+        return 0;
+    }
+    const void *newline = std::memchr(data + b - 1, '\n', size - b + 1);
+    return newline ? static_cast<const char *>(newline) - data + 1 : size;
+}
+
+// Legge solo le righe della parte shard di numShards del file (ad esempio un rank MPI): il file viene
+// diviso in parti di byte uguali, quindi ogni processo converte circa 1/numShards delle righe
+template<typename Store>
+bool parseDatasetShard(const std::string &path, int shard, int numShards, Store &store) {
+    mappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    std::size_t begin = shardBoundary(file.data(), file.size(), shard, numShards);
+    std::size_t end = shardBoundary(file.data(), file.size(), shard + 1, numShards);
+    parseDatasetBytes(file.data() + begin, end - begin, store);
+    return true;
+}
+
+// Destinazione SoA: due vettori di coordinate
+struct soaStore {
+    std::vector<double> &x_vec;
+    std::vector<double> &y_vec;
+
+    int dimension() const {
+        return 2;
+    }
+
+    void resize(std::size_t n) {
+        x_vec.resize(n);
+        y_vec.resize(n);
+    }
+
+    void set(std::size_t i, const double *values) {
+        x_vec[i] = values[0];
+        y_vec[i] = values[1];
+    }
+
+    void move(std::size_t dst, std::size_t src, std::size_t n) {
+        std::copy(x_vec.begin() + src, x_vec.begin() + src + n, x_vec.begin() + dst);
+        std::copy(y_vec.begin() + src, y_vec.begin() + src + n, y_vec.begin() + dst);
+    }
+};
+
+// Destinazione AoS: qualunque struttura punto con x, y e clusterID
+template<typename P>
+struct aosStore {
+    std::vector<P> &points;
+
+    int dimension() const {
+        return 2;
+    }
+
+    void resize(std::size_t n) {
+        points.resize(n);
+    }
+
+    void set(std::size_t i, const double *values) {
+        points[i].x = values[0];
+        points[i].y = values[1];
+        points[i].clusterID = -1;
+    }
+
+    void move(std::size_t dst, std::size_t src, std::size_t n) {
+        std::copy(points.begin() + src, points.begin() + src + n, points.begin() + dst);
+    }
+};
+
+// Destinazione a righe: dim coordinate per punto, contigue (row-major)
+struct rowStore {
+    std::vector<double> &values;
+    int dim;
+
+    int dimension() const {
+        return dim;
+    }
+
+    void resize(std::size_t n) {
+        values.resize(n * dim);
+    }
+
+    void set(std::size_t i, const double *row) {
+        std::copy(row, row + dim, values.begin() + i * dim);
+    }
+
+    void move(std::size_t dst, std::size_t src, std::size_t n) {
+        std::copy(values.begin() + src * dim, values.begin() + (src + n) * dim, values.begin() + dst * dim);
+    }
+};
+
+// Numero di coordinate della prima riga non vuota del file, 0 se il file non esiste o è vuoto,
+// -1 se le coordinate sono più di maxParsedDimension (il file non va troncato alle prime colonne)
+inline int datasetDimension(const std::string &path) {
+    mappedFile file;
+    if (!file.open(path)) {
+        return 0;
+    }
+    const char *p = file.data();
+    const char *end = p + file.size();
+    while (p < end) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        int dim = 0;
+        double value;
+        for (const char *q = parseNumber(p, lineEnd, value); q; q = parseNumber(q, lineEnd, value)) {
+            dim++;
+        }
+        if (dim > 0) {
+            return dim <= maxParsedDimension ? dim : -1;
+        }
+        p = lineEnd + 1;
+    }
+    return 0;
+}
+
+inline bool parseDatasetSoA(const std::string &path, std::vector<double> &x_vec, std::vector<double> &y_vec) {
+    soaStore store{x_vec, y_vec};
+    return parseDatasetFile(path, store);
+}
+
+template<typename P>
+bool parseDatasetAoS(const std::string &path, std::vector<P> &points) {
+    aosStore<P> store{points};
+    return parseDatasetFile(path, store);
+}
+
+inline bool parseDatasetRows(const std::string &path, int dim, std::vector<double> &values) {
+    rowStore store{values, dim};
+    return parseDatasetFile(path, store);
+}
+
+#endif // KMEANS_DATASET_PARSER_H
@@ -0,0 +1,151 @@
+//
+// K-means di Elkan: stesso risultato del ciclo di Lloyd, ma la disuguaglianza triangolare
+// permette di saltare la maggior parte dei calcoli di distanza punto-centroide.
+//
+
+#ifndef KMEANS_ELKAN_H
+#define KMEANS_ELKAN_H
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "kmeans.h"
+
+// Per ogni punto si tengono un limite superiore alla distanza dal proprio centroide e un limite
+// inferiore alla distanza da ciascun centroide. Un centroide c viene valutato solo se
+// upper > lower[c] e upper > d(a, c) / 2, dove a è il centroide assegnato.
+// skippedDistances riceve, per ogni iterazione, il numero di distanze non calcolate.
+inline std::vector<cluster> kmeanElkan(std::vector<cluster> &clusters, std::vector<point> &points, int maxIter,
+                                       std::vector<long long> &skippedDistances) {
+    int numClusters = clusters.size();
+    std::size_t numPoints = points.size();
+
+    std::vector<point> centroids(numClusters);
+    for (int c = 0; c < numClusters; c++) {
+        centroids[c] = clusters[c].getCentroid();
+    }
+
+    std::vector<double> upper(numPoints);
+    std::vector<double> lower(numPoints * numClusters);
+    std::vector<char> upperStale(numPoints, 0); // upper è solo un limite e va ricalcolato prima dell'uso
+    std::vector<double> centerDist(numClusters * numClusters);
+    std::vector<double> halfMinDist(numClusters);
+    std::vector<double> shift(numClusters);
+
+    bool centerUpdated;
+    int i = 0;
+    skippedDistances.clear();
+
+    do {
+        centerUpdated = false;
+        if (i % 10 == 0)
+            std::cout << "[Seq] Numero iterazioni k-means (Elkan): " << i << std::endl;
+        long long computed = 0;
+
+        // Distanze tra centroidi e metà della distanza dal centroide più vicino
+        for (int a = 0; a < numClusters; a++) {
+            halfMinDist[a] = INFINITY;
+            for (int b = 0; b < numClusters; b++) {
+                centerDist[a * numClusters + b] = pointDistance(centroids[a], centroids[b]);
+                if (b != a) {
+                    halfMinDist[a] = std::min(halfMinDist[a], 0.5 * centerDist[a * numClusters + b]);
+                }
+            }
+        }
+
+        for (std::size_t p = 0; p < numPoints; p++) {
+            point &pt = points[p];
+            double *l = &lower[p * numClusters];
+            int assigned;
+
+            if (i == 0) {
+                // Prima iterazione: tutte le distanze, che inizializzano i limiti
+                double minDist = INFINITY;
+                assigned = 0;
+                for (int c = 0; c < numClusters; c++) {
+                    l[c] = pointDistance(pt, centroids[c]);
+                    if (l[c] < minDist) {
+                        minDist = l[c];
+                        assigned = c;
+                    }
+                }
+                computed += numClusters;
+                upper[p] = minDist;
+            } else {
+                assigned = pt.clusterID;
+
+                // Nessun altro centroide può essere più vicino di quello assegnato
+                if (upper[p] <= halfMinDist[assigned]) {
+                    continue;
+                }
+
+                for (int c = 0; c < numClusters; c++) {
+                    if (c == assigned || upper[p] <= l[c] ||
+                        upper[p] <= 0.5 * centerDist[assigned * numClusters + c]) {
+                        continue;
+                    }
+                    if (upperStale[p]) {
+                        upper[p] = pointDistance(pt, centroids[assigned]);
+                        l[assigned] = upper[p];
+                        upperStale[p] = 0;
+                        computed++;
+                        if (upper[p] <= l[c] || upper[p] <= 0.5 * centerDist[assigned * numClusters + c]) {
+                            continue;
+                        }
+                    }
+                    l[c] = pointDistance(pt, centroids[c]);
+                    computed++;
+                    if (l[c] < upper[p]) {
+                        assigned = c;
+                        upper[p] = l[c];
+                    }
+                }
+            }
+
+            if (pt.clusterID != assigned) {
+                centerUpdated = true; // Se nessun punto cambia cluster allora termino
+            }
+            pt.clusterID = assigned;
+        }
+
+        skippedDistances.push_back(static_cast<long long>(numPoints) * numClusters - computed);
+        i++;
+
+        if (centerUpdated) {
+            // Le somme vengono fatte nello stesso ordine del ciclo di Lloyd, così i centroidi coincidono
+            for (auto &cluster: clusters) {
+                cluster.resetTotalX();
+                cluster.resetTotalY();
+                cluster.resetCountPoints();
+            }
+            for (auto &pt: points) {
+                clusters[pt.clusterID].addTotalX(pt.x);
+                clusters[pt.clusterID].addTotalY(pt.y);
+                clusters[pt.clusterID].countPoints();
+            }
+            for (int c = 0; c < numClusters; c++) {
+                clusters[c].updateCentroid();
+                point moved = clusters[c].getCentroid();
+                shift[c] = pointDistance(centroids[c], moved);
+                centroids[c] = moved;
+            }
+
+            // Spostando i centroidi i limiti si allargano al più dello spostamento
+            for (std::size_t p = 0; p < numPoints; p++) {
+                double *l = &lower[p * numClusters];
+                for (int c = 0; c < numClusters; c++) {
+                    l[c] = std::max(l[c] - shift[c], 0.0);
+                }
+                if (shift[points[p].clusterID] > 0) {
+                    upper[p] += shift[points[p].clusterID];
+                    upperStale[p] = 1;
+                }
+            }
+        }
+    } while (centerUpdated && i <= maxIter);
+
+    return clusters;
+}
+
+#endif // KMEANS_ELKAN_H
@@ -0,0 +1,38 @@
+//
+// Generatore del dataset sintetico da riga di comando, per preparare dataset di benchmark
+// anche molto grandi senza passare da sequential.cpp.
+//
+// Uso: generate_dataset [punti per cluster] [cluster] [seme] [txt|bin]
+//
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include "dataset_generator.h"
+
+int main(int argc, char *argv[]) {
+    long long numPointsPerCluster = argc > 1 ? std::stoll(argv[1]) : 100000;
+    int numClusters = argc > 2 ? std::stoi(argv[2]) : 10;
+    unsigned long long seed = argc > 3 ? std::stoull(argv[3]) : 1;
+    bool binary = argc > 4 && std::string(argv[4]) == "bin";
+    int centerDist = 200;
+    int stdDev = 15;
+    int rangeX = 700;
+    int rangeY = 350;
+
+    std::string path = binary ? "../dataset/dataset.bin" : "../dataset/dataset.txt";
+    std::cout << "[Gen] Generazione di " << numPointsPerCluster * numClusters << " punti (" << numClusters
+              << " cluster, seme " << seed << ") in " << path << std::endl;
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    if (!generateDatasetFile(path, numPointsPerCluster, numClusters, centerDist, stdDev, rangeX, rangeY, seed,
+                             binary)) {
+        std::cerr << "[Gen] Errore nella scrittura del file" << std::endl;
+        return 1;
+    }
+    std::chrono::duration<double> elapsed_seconds = std::chrono::steady_clock::now() - start_time;
+
+    std::cout << "[Gen] Dataset generato in " << elapsed_seconds.count() << " secondi ("
+              << numPointsPerCluster * numClusters / elapsed_seconds.count() << " punti/s)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,170 @@
+//
+// Scelta automatica del numero di cluster: k-means viene eseguito per ogni K in [kMin, kMax] e per
+// ognuno si calcolano l'inerzia (per il metodo del gomito) e la silhouette su un campione di punti.
+// Tutti i K partono insieme e condividono le passate sui punti (kmeanLockstep di restarts.h).
+// I centroidi iniziali sono annidati: quelli di K sono quelli di K - 1 più un nuovo centroide scelto
+// da k-means++, quindi basta un solo k-means++ con kMax centroidi per tutti i K.
+//
+
+#ifndef KMEANS_K_SELECTION_H
+#define KMEANS_K_SELECTION_H
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <span>
+#include <unordered_set>
+#include <vector>
+#include <omp.h>
+#include "kmeans.h"
+#include "restarts.h"
+#include "seeding.h"
+
+// Punti usati per la silhouette: il calcolo esatto è quadratico nel numero di punti
+const std::size_t silhouetteSampleSize = 2000;
+
+struct sweepResult {
+    int numCluster = 0;
+    double inertia = 0;
+    double silhouette = 0;  // media sul campione, tra -1 e 1 (0 con un solo cluster)
+    restartResult run;
+};
+
+// Silhouette media dei punti sample: per ogni punto a è la distanza media dai punti del campione nel
+// suo cluster, b la minore tra le distanze medie dai punti degli altri cluster, s = (b - a) / max(a, b).
+// Un punto che è l'unico del proprio cluster nel campione vale 0
+inline double sampledSilhouette(std::span<const double> x_values, std::span<const double> y_values,
+                                const std::vector<std::size_t> &sample, const std::vector<int> &points_id,
+                                int numCluster) {
+    std::size_t n = sample.size();
+    if (n < 2 || numCluster < 2) {
+        return 0;
+    }
+    double total = 0;
+#pragma omp parallel reduction(+:total)
+    {
+        std::vector<double> distSum(numCluster);
+        std::vector<int> count(numCluster);
+#pragma omp for schedule(static)
+        for (std::size_t i = 0; i < n; i++) {
+            std::fill(distSum.begin(), distSum.end(), 0.0);
+            std::fill(count.begin(), count.end(), 0);
+            double xi = x_values[sample[i]], yi = y_values[sample[i]];
+            for (std::size_t j = 0; j < n; j++) {
+                if (j == i) {
+                    continue;
+                }
+                double dx = xi - x_values[sample[j]];
+                double dy = yi - y_values[sample[j]];
+                int c = points_id[sample[j]];
+                distSum[c] += std::sqrt(dx * dx + dy * dy);
+                count[c]++;
+            }
+            int own = points_id[sample[i]];
+            if (count[own] == 0) {
+                continue;
+            }
+            double a = distSum[own] / count[own];
+            double b = INFINITY;
+            for (int c = 0; c < numCluster; c++) {
+                if (c != own && count[c] > 0) {
+                    b = std::min(b, distSum[c] / count[c]);
+                }
+            }
+            if (b < INFINITY && std::max(a, b) > 0) {
+                total += (b - a) / std::max(a, b);
+            }
+        }
+    }
+    return total / n;
+}
+
+// Gomito della curva dell'inerzia: il K più lontano dalla retta tra il primo e l'ultimo punto, con K e
+// logaritmo dell'inerzia riportati in [0, 1]. Il logaritmo evita che il primo salto, molto più grande
+// degli altri, schiacci il resto della curva
+inline int elbowCluster(const std::vector<sweepResult> &sweep) {
+    if (sweep.size() < 3) {
+        return sweep.empty() ? 0 : sweep.front().numCluster;
+    }
+    auto logInertia = [](const sweepResult &s) { return std::log(std::max(s.inertia, 1e-300)); };
+    const sweepResult &first = sweep.front(), &last = sweep.back();
+    double kRange = last.numCluster - first.numCluster;
+    double inertiaRange = logInertia(first) - logInertia(last);
+    if (inertiaRange <= 0) {
+        return first.numCluster;
+    }
+    int best = first.numCluster;
+    double bestDistance = -INFINITY;
+    for (const sweepResult &s: sweep) {
+        double k = (s.numCluster - first.numCluster) / kRange;
+        double inertia = (logInertia(s) - logInertia(last)) / inertiaRange;
+        // Distanza (a meno di una costante) dalla retta da (0, 1) a (1, 0)
+        double distance = 1 - k - inertia;
+        if (distance > bestDistance) {
+            bestDistance = distance;
+            best = s.numCluster;
+        }
+    }
+    return best;
+}
+
+// Esegue k-means per ogni K in [kMin, kMax]
+inline std::vector<sweepResult> kmeanSweep(std::span<const double> x_values, std::span<const double> y_values,
+                                           int kMin, int kMax, int maxIter, unsigned long long seed) {
+    std::vector<sweepResult> sweep;
+    std::size_t numPoints = x_values.size();
+    kMin = std::max(kMin, 1);
+    if (numPoints == 0 || kMax < kMin) {
+        return sweep;
+    }
+
+    std::vector<point> points(numPoints);
+#pragma omp parallel for schedule(static)
+    for (std::size_t j = 0; j < numPoints; j++) {
+        points[j] = point{x_values[j], y_values[j], -1};
+    }
+    double seedStart = omp_get_wtime();
+    std::vector<point> seeds = seedKmeansPlusPlus(points, kMax, seed);
+    double seedingSeconds = omp_get_wtime() - seedStart;
+    points = std::vector<point>();
+
+    std::vector<restartResult> runs(kMax - kMin + 1);
+    for (int k = kMin; k <= kMax; k++) {
+        restartResult &run = runs[k - kMin];
+        run.seed = seed;
+        run.seedingSeconds = seedingSeconds;
+        for (int c = 0; c < k; c++) {
+            run.x_centroids.push_back(seeds[c].x);
+            run.y_centroids.push_back(seeds[c].y);
+        }
+    }
+    kmeanLockstep(x_values, y_values, runs, maxIter, "[Sweep]");
+
+    // Lo stesso campione per tutti i K, così le silhouette sono confrontabili. Gli indici sono distinti
+    // (algoritmo di Floyd): un punto ripetuto conterebbe come un vicino a distanza 0 nel proprio cluster
+    std::mt19937_64 gen(seed);
+    std::size_t sampleSize = std::min(numPoints, silhouetteSampleSize);
+    std::vector<std::size_t> sample;
+    sample.reserve(sampleSize);
+    std::unordered_set<std::size_t> chosen;
+    for (std::size_t j = numPoints - sampleSize; j < numPoints; j++) {
+        std::size_t p = std::uniform_int_distribution<std::size_t>(0, j)(gen);
+        if (!chosen.insert(p).second) {
+            p = j;
+            chosen.insert(j);
+        }
+        sample.push_back(p);
+    }
+
+    for (int k = kMin; k <= kMax; k++) {
+        sweepResult s;
+        s.numCluster = k;
+        s.run = std::move(runs[k - kMin]);
+        s.inertia = s.run.inertia;
+        s.silhouette = sampledSilhouette(x_values, y_values, sample, s.run.points_id, k);
+        sweep.push_back(std::move(s));
+    }
+    return sweep;
+}
+
+#endif // KMEANS_K_SELECTION_H
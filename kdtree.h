@@ -0,0 +1,266 @@
+//
+// Algoritmo di filtraggio di Kanungo et al.: un albero k-d costruito una sola volta sui punti
+// permette di assegnare interi sottoalberi a un centroide senza esaminare i singoli punti.
+//
+
+#ifndef KMEANS_KDTREE_H
+#define KMEANS_KDTREE_H
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "kmeans.h"
+
+// Nodo dell'albero. I nodi sono salvati in ordine anticipato: il figlio sinistro segue il padre
+// e il sottoalbero di un nodo occupa gli indici [nodo, subtreeEnd)
+struct kdNode {
+    double minX, minY, maxX, maxY; // cella (bounding box dei punti del nodo)
+    double sumX, sumY;             // somma pesata dei punti del nodo
+    int count;
+    int begin, end;                // intervallo dei punti del nodo in kdTree::order
+    int right = -1;                // -1 per le foglie
+    int subtreeEnd;
+};
+
+struct kdTree {
+    std::vector<kdNode> nodes;
+    std::vector<int> order; // indici dei punti, raggruppati per nodo
+    int depth = 0;
+};
+
+inline int buildKdNode(kdTree &tree, const std::vector<point> &points, int begin, int end, int depth,
+                       int leafSize) {
+    int index = tree.nodes.size();
+    tree.nodes.emplace_back();
+    tree.depth = std::max(tree.depth, depth);
+
+    kdNode node{};
+    node.minX = node.minY = INFINITY;
+    node.maxX = node.maxY = -INFINITY;
+    node.sumX = node.sumY = 0;
+    node.count = end - begin;
+    node.begin = begin;
+    node.end = end;
+    for (int i = begin; i < end; i++) {
+        const point &p = points[tree.order[i]];
+        node.minX = std::min(node.minX, p.x);
+        node.maxX = std::max(node.maxX, p.x);
+        node.minY = std::min(node.minY, p.y);
+        node.maxY = std::max(node.maxY, p.y);
+        node.sumX += p.x;
+        node.sumY += p.y;
+    }
+
+    if (end - begin > leafSize) {
+        // Divisione sulla mediana della dimensione più estesa
+        bool splitX = node.maxX - node.minX >= node.maxY - node.minY;
+        int mid = begin + (end - begin) / 2;
+        std::nth_element(tree.order.begin() + begin, tree.order.begin() + mid, tree.order.begin() + end,
+                         [&](int a, int b) {
+                             return splitX ? points[a].x < points[b].x : points[a].y < points[b].y;
+                         });
+        buildKdNode(tree, points, begin, mid, depth + 1, leafSize);
+        node.right = buildKdNode(tree, points, mid, end, depth + 1, leafSize);
+    }
+    node.subtreeEnd = tree.nodes.size();
+    tree.nodes[index] = node;
+    return index;
+}
+
+// Costruisce l'albero una volta sola, dopo extractDataset
+inline kdTree buildKdTree(const std::vector<point> &points, int leafSize = 16) {
+    kdTree tree;
+    tree.order.resize(points.size());
+    for (int i = 0; i < static_cast<int>(points.size()); i++) {
+        tree.order[i] = i;
+    }
+    tree.nodes.reserve(4 * points.size() / leafSize + 1);
+    if (!points.empty()) {
+        buildKdNode(tree, points, 0, points.size(), 0, leafSize);
+    }
+    return tree;
+}
+
+// Una passata di assegnazione sull'albero. Per ogni nodo si tengono i centroidi candidati:
+// quelli più lontani di z* da ogni punto della cella vengono scartati e, se ne resta uno solo,
+// l'intero sottoalbero gli viene assegnato usando la somma pesata del nodo
+class kdFilter {
+
+private:
+    const kdTree &tree;
+    std::vector<point> &points;
+    int numClusters;
+    const point *centroids = nullptr;
+
+    std::vector<int> candidates;  // liste di candidati, una per livello dell'albero
+    std::vector<int> nodeOwner;   // centroide a cui era assegnato per intero il nodo, -1 altrimenti
+
+    std::vector<double> sumX;
+    std::vector<double> sumY;
+    std::vector<int> count;
+    bool changed = false;
+    long long computed = 0;
+
+    static double squaredDistance(double x, double y, const point &c) {
+        return (c.x - x) * (c.x - x) + (c.y - y) * (c.y - y);
+    }
+
+    // z è più lontano di best da tutti i punti della cella se lo è dal vertice nella direzione z - best
+    bool isFarther(int z, int best, const kdNode &node) {
+        double vx = centroids[z].x > centroids[best].x ? node.maxX : node.minX;
+        double vy = centroids[z].y > centroids[best].y ? node.maxY : node.minY;
+        computed += 2;
+        return squaredDistance(vx, vy, centroids[z]) >= squaredDistance(vx, vy, centroids[best]);
+    }
+
+    void assignSubtree(int index, int owner) {
+        const kdNode &node = tree.nodes[index];
+        sumX[owner] += node.sumX;
+        sumY[owner] += node.sumY;
+        count[owner] += node.count;
+
+        // Se il nodo era già tutto di owner le etichette sono già corrette
+        if (nodeOwner[index] == owner) {
+            return;
+        }
+        for (int i = node.begin; i < node.end; i++) {
+            point &p = points[tree.order[i]];
+            if (p.clusterID != owner) {
+                changed = true;
+                p.clusterID = owner;
+            }
+        }
+        std::fill(nodeOwner.begin() + index, nodeOwner.begin() + node.subtreeEnd, owner);
+    }
+
+    void assignLeaf(int index, const int *cand, int numCand) {
+        const kdNode &node = tree.nodes[index];
+        nodeOwner[index] = -1;
+        for (int i = node.begin; i < node.end; i++) {
+            point &p = points[tree.order[i]];
+            double minDist = INFINITY;
+            int minIndex = cand[0];
+            for (int k = 0; k < numCand; k++) {
+                double dist = squaredDistance(p.x, p.y, centroids[cand[k]]);
+                if (dist < minDist) {
+                    minDist = dist;
+                    minIndex = cand[k];
+                }
+            }
+            computed += numCand;
+            if (p.clusterID != minIndex) {
+                changed = true;
+                p.clusterID = minIndex;
+            }
+            sumX[minIndex] += p.x;
+            sumY[minIndex] += p.y;
+            count[minIndex]++;
+        }
+    }
+
+    void filter(int index, const int *cand, int numCand, int depth) {
+        const kdNode &node = tree.nodes[index];
+
+        // z*: il candidato più vicino al centro della cella
+        double midX = (node.minX + node.maxX) / 2;
+        double midY = (node.minY + node.maxY) / 2;
+        int best = cand[0];
+        double bestDist = INFINITY;
+        for (int k = 0; k < numCand; k++) {
+            double dist = squaredDistance(midX, midY, centroids[cand[k]]);
+            if (dist < bestDist) {
+                bestDist = dist;
+                best = cand[k];
+            }
+        }
+        computed += numCand;
+
+        // I candidati restano in ordine di indice, come nel ciclo di Lloyd
+        int *kept = &candidates[(depth + 1) * numClusters];
+        int numKept = 0;
+        for (int k = 0; k < numCand; k++) {
+            if (cand[k] == best || !isFarther(cand[k], best, node)) {
+                kept[numKept++] = cand[k];
+            }
+        }
+
+        if (numKept == 1) {
+            assignSubtree(index, best);
+        } else if (node.right < 0) {
+            assignLeaf(index, kept, numKept);
+        } else {
+            nodeOwner[index] = -1;
+            filter(index + 1, kept, numKept, depth + 1);
+            filter(node.right, kept, numKept, depth + 1);
+        }
+    }
+
+public:
+
+    kdFilter(const kdTree &tree, std::vector<point> &points, int numClusters)
+            : tree(tree), points(points), numClusters(numClusters),
+              candidates((tree.depth + 2) * numClusters), nodeOwner(tree.nodes.size(), -1),
+              sumX(numClusters), sumY(numClusters), count(numClusters) {
+        for (int c = 0; c < numClusters; c++) {
+            candidates[c] = c;
+        }
+    }
+
+    // Assegna tutti i punti e aggiorna i totali dei cluster. Ritorna true se un punto ha cambiato cluster
+    bool assign(const std::vector<point> &currentCentroids, std::vector<cluster> &clusters, long long &distances) {
+        centroids = currentCentroids.data();
+        std::fill(sumX.begin(), sumX.end(), 0.0);
+        std::fill(sumY.begin(), sumY.end(), 0.0);
+        std::fill(count.begin(), count.end(), 0);
+        changed = false;
+        computed = 0;
+
+        if (!tree.nodes.empty()) {
+            filter(0, candidates.data(), numClusters, 0);
+        }
+
+        for (int c = 0; c < numClusters; c++) {
+            clusters[c].setTotals(sumX[c], sumY[c], count[c]);
+        }
+        distances = computed;
+        return changed;
+    }
+};
+
+// K-means con l'algoritmo di filtraggio: stessa terminazione del ciclo di Lloyd.
+// skippedDistances riceve per ogni iterazione N * K meno le distanze calcolate (punti e celle)
+inline std::vector<cluster> kmeanKdTree(std::vector<cluster> &clusters, std::vector<point> &points,
+                                        const kdTree &tree, int maxIter, std::vector<long long> &skippedDistances) {
+    int numClusters = clusters.size();
+    kdFilter filter(tree, points, numClusters);
+    std::vector<point> centroids(numClusters);
+
+    bool centerUpdated;
+    int i = 0;
+    skippedDistances.clear();
+
+    do {
+        if (i % 10 == 0)
+            std::cout << "[Seq] Numero iterazioni k-means (k-d tree): " << i << std::endl;
+        i++;
+
+        for (int c = 0; c < numClusters; c++) {
+            centroids[c] = clusters[c].getCentroid();
+        }
+
+        long long computed;
+        centerUpdated = filter.assign(centroids, clusters, computed); // Se nessun punto cambia cluster allora termino
+        skippedDistances.push_back(static_cast<long long>(points.size()) * numClusters - computed);
+
+        if (centerUpdated) {
+            for (auto &cluster: clusters) {
+                cluster.updateCentroid();
+            }
+        }
+    } while (centerUpdated && i <= maxIter);
+
+    return clusters;
+}
+
+#endif // KMEANS_KDTREE_H
@@ -0,0 +1,93 @@
+//
+// Tipi comuni alle versioni AoS di k-means: punto, cluster e distanza tra punti.
+//
+
+#ifndef KMEANS_KMEANS_H
+#define KMEANS_KMEANS_H
+
+#include <cmath>
+#include <vector>
+
+struct point {
+    double x;
+    double y;
+    int clusterID;
+};
+
+class cluster {
+
+private:
+    point centroid{};
+    std::vector<point> points;
+    double totalX = 0;
+    double totalY = 0;
+    int count = 0;
+
+public:
+
+    void addTotalX(double x) {
+        totalX += x;
+    }
+
+    void addTotalY(double y) {
+        totalY += y;
+    }
+
+    void countPoints() {
+        count++;
+    }
+
+    void resetCountPoints() {
+        count = 0;
+    }
+
+    void resetTotalX() {
+        totalX = 0;
+    }
+
+    void resetTotalY() {
+        totalY = 0;
+    }
+
+    void setTotals(double x, double y, int n) {
+        totalX = x;
+        totalY = y;
+        count = n;
+    }
+
+    // Aggiornamento incrementale: somma (o toglie, con valori negativi) coordinate e conteggio
+    void addTotals(double x, double y, int n) {
+        totalX += x;
+        totalY += y;
+        count += n;
+    }
+
+
+    void createCentroid(point c) {
+        centroid = c;
+    }
+
+    void updateCentroid() {
+        if (count > 0) {
+            centroid.x = totalX / count;
+            centroid.y = totalY / count;
+        } else {
+            // Se non ci sono punti assegnati al cluster, mantieni il centroide invariato
+        }
+    }
+
+    point getCentroid() {
+        return centroid;
+    }
+
+    int getCount() {
+        return count;
+    }
+};
+
+// Distanza euclidea, calcolata come nel ciclo di Lloyd
+inline double pointDistance(const point &a, const point &b) {
+    return std::sqrt(std::pow(a.x - b.x, 2) + std::pow(a.y - b.y, 2));
+}
+
+#endif // KMEANS_KMEANS_H
@@ -0,0 +1,225 @@
+//
+// K-means distribuito con MPI, senza grafica. Ogni rank carica solo la propria parte del dataset:
+// dal file binario (mappato, righe [n*r/P, n*(r+1)/P)) oppure dal file di testo (parte r di P dei byte).
+//
+// Uso: mpirun -np N kmeans_mpi [dataset] [cluster] [iterazioni massime] [seme] [modello]
+// I centroidi iniziali vengono da ../dataset/centroids.txt se contiene almeno K righe, altrimenti da
+// k-means++ su un campione di punti raccolto da tutti i rank. Al termine il rank 0 stampa, per ogni
+// iterazione, il tempo di calcolo (massimo e minimo tra i rank) e quello di comunicazione.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+#include <mpi.h>
+#include <omp.h>
+#include "kmeans.h"
+#include "kmeans_mpi.h"
+#include "dataset_binary.h"
+#include "dataset_parser.h"
+#include "model.h"
+#include "seeding.h"
+
+// Punti richiesti a ogni rank per la scelta dei centroidi iniziali
+const std::size_t seedingSamplePerRank = 20000;
+
+// Parte del dataset di questo rank. Ritorna false se il file non può essere letto o non è bidimensionale
+bool loadShard(const std::string &path, int rank, int numRanks, std::vector<double> &x_values,
+               std::vector<double> &y_values) {
+    mappedDataset binaryDataset;
+    if (binaryDataset.open(path)) {
+        if (binaryDataset.dimension() != 2) {
+            return false;
+        }
+        std::size_t n = binaryDataset.size();
+        std::size_t first = n * rank / numRanks;
+        std::size_t last = n * (rank + 1) / numRanks;
+        // Le colonne del rank vengono copiate: la memoria resta solo quella della propria parte
+        if (binaryDataset.type() == datasetFloat32) {
+            std::span<const float> x = binaryDataset.column<float>(0).subspan(first, last - first);
+            std::span<const float> y = binaryDataset.column<float>(1).subspan(first, last - first);
+            x_values.assign(x.begin(), x.end());
+            y_values.assign(y.begin(), y.end());
+        } else {
+            std::span<const double> x = binaryDataset.column(0).subspan(first, last - first);
+            std::span<const double> y = binaryDataset.column(1).subspan(first, last - first);
+            x_values.assign(x.begin(), x.end());
+            y_values.assign(y.begin(), y.end());
+        }
+        return true;
+    }
+    soaStore store{x_values, y_values};
+    return parseDatasetShard(path, rank, numRanks, store);
+}
+
+// Centroidi iniziali uguali su tutti i rank
+bool initialCentroids(const std::vector<double> &x_values, const std::vector<double> &y_values, int numCluster,
+                      unsigned long long seed, int rank, int numRanks, std::vector<double> &x_centroids,
+                      std::vector<double> &y_centroids) {
+    // Il rank 0 prova il file dei centroidi e comunica agli altri se va bene
+    int fromFile = 0;
+    if (rank == 0) {
+        fromFile = parseDatasetSoA("../dataset/centroids.txt", x_centroids, y_centroids) &&
+                   x_centroids.size() >= static_cast<std::size_t>(numCluster);
+    }
+    MPI_Bcast(&fromFile, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    if (!fromFile) {
+        // Ogni rank estrae un campione dei propri punti, il rank 0 esegue k-means++ sull'unione
+        std::mt19937_64 gen(seed + rank);
+        std::size_t n = x_values.size();
+        std::size_t sampleSize = std::min(n, seedingSamplePerRank);
+        std::vector<double> sample;
+        for (std::size_t j = 0; j < sampleSize; j++) {
+            std::size_t p = std::uniform_int_distribution<std::size_t>(0, n - 1)(gen);
+            sample.push_back(x_values[p]);
+            sample.push_back(y_values[p]);
+        }
+
+        int sampleCount = static_cast<int>(sample.size());
+        std::vector<int> counts(numRanks), offsets(numRanks, 0);
+        MPI_Gather(&sampleCount, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+        std::vector<double> gathered;
+        if (rank == 0) {
+            for (int r = 1; r < numRanks; r++) {
+                offsets[r] = offsets[r - 1] + counts[r - 1];
+            }
+            gathered.resize(offsets[numRanks - 1] + counts[numRanks - 1]);
+        }
+        MPI_Gatherv(sample.data(), sampleCount, MPI_DOUBLE, gathered.data(), counts.data(), offsets.data(),
+                    MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+        if (rank == 0) {
+            std::vector<point> points(gathered.size() / 2);
+            for (std::size_t j = 0; j < points.size(); j++) {
+                points[j] = point{gathered[2 * j], gathered[2 * j + 1], -1};
+            }
+            std::vector<point> seeds = seedKmeansPlusPlus(points, numCluster, seed);
+            x_centroids.clear();
+            y_centroids.clear();
+            for (const auto &c: seeds) {
+                x_centroids.push_back(c.x);
+                y_centroids.push_back(c.y);
+            }
+            std::cout << "[MPI] Centroidi iniziali da k-means++ su " << points.size() << " punti campionati"
+                      << std::endl;
+        }
+    }
+
+    int numCentroids = rank == 0 ? static_cast<int>(std::min<std::size_t>(x_centroids.size(), numCluster)) : 0;
+    MPI_Bcast(&numCentroids, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    x_centroids.resize(numCentroids);
+    y_centroids.resize(numCentroids);
+    MPI_Bcast(x_centroids.data(), numCentroids, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Bcast(y_centroids.data(), numCentroids, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    return numCentroids == numCluster;
+}
+
+int main(int argc, char *argv[]) {
+    // Le chiamate MPI vengono fatte solo fuori dalle regioni parallele OpenMP
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    int rank, numRanks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+
+    std::string path = argc > 1 ? argv[1] : "../dataset/dataset.txt";
+    int numCluster = argc > 2 ? std::stoi(argv[2]) : 10;
+    int maxIter = argc > 3 ? std::stoi(argv[3]) : 150;
+    unsigned long long seed = argc > 4 ? std::stoull(argv[4]) : 1;
+    std::string modelPath = argc > 5 ? argv[5] : "../dataset/model.kmm";
+
+    if (rank == 0) {
+        std::cout << "[MPI] Versione kmeans distribuita con MPI\n" << std::endl;
+        std::cout << "[MPI] Rank: " << numRanks << ", thread per rank: " << omp_get_max_threads() << std::endl;
+    }
+
+    std::chrono::steady_clock::time_point load_start = std::chrono::steady_clock::now();
+    std::vector<double> x_values, y_values;
+    // Una parte vuota è ammessa (file piccolo o molti rank): le somme di MPI_Allreduce restano corrette
+    int loaded = loadShard(path, rank, numRanks, x_values, y_values);
+    int allLoaded;
+    MPI_Allreduce(&loaded, &allLoaded, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if (!allLoaded) {
+        if (!loaded) {
+            std::cerr << "[MPI] Rank " << rank << ": errore nella lettura della propria parte di " << path
+                      << std::endl;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    std::chrono::duration<double> load_seconds = std::chrono::steady_clock::now() - load_start;
+
+    long long localPoints = x_values.size();
+    long long numPoints;
+    MPI_Allreduce(&localPoints, &numPoints, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    if (numPoints == 0) {
+        if (rank == 0) {
+            std::cerr << "[MPI] Nessun punto valido in " << path << std::endl;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    if (rank == 0) {
+        std::cout << "[MPI] Punti caricati: " << numPoints << " in " << load_seconds.count() << " secondi"
+                  << std::endl;
+    }
+
+    std::vector<double> x_centroids, y_centroids;
+    if (!initialCentroids(x_values, y_values, numCluster, seed, rank, numRanks, x_centroids, y_centroids)) {
+        if (rank == 0) {
+            std::cerr << "[MPI] Impossibile scegliere " << numCluster << " centroidi iniziali" << std::endl;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start_time = MPI_Wtime();
+    int iterations = 0;
+    std::vector<mpiIterationTimes> times;
+    auto [x_centroids_new, y_centroids_new, points_id] =
+            kmeanMPI(x_centroids, y_centroids, x_values, y_values, numCluster, maxIter, MPI_COMM_WORLD,
+                     &iterations, &times);
+    double elapsed_seconds = MPI_Wtime() - start_time;
+
+    // Tempi per iterazione: massimo e minimo del calcolo tra i rank (la differenza è lo sbilanciamento)
+    // e massimo della comunicazione
+    std::vector<double> compute(times.size()), communication(times.size());
+    for (std::size_t it = 0; it < times.size(); it++) {
+        compute[it] = times[it].compute;
+        communication[it] = times[it].communication;
+    }
+    std::vector<double> computeMax(times.size()), computeMin(times.size()), communicationMax(times.size());
+    int count = static_cast<int>(times.size());
+    MPI_Reduce(compute.data(), computeMax.data(), count, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(compute.data(), computeMin.data(), count, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+    MPI_Reduce(communication.data(), communicationMax.data(), count, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        double totalCompute = 0, totalCommunication = 0;
+        for (int it = 0; it < count; it++) {
+            std::cout << "[MPI] Iterazione " << it + 1 << ": calcolo " << computeMax[it] << " s (min "
+                      << computeMin[it] << " s), comunicazione " << communicationMax[it] << " s" << std::endl;
+            totalCompute += computeMax[it];
+            totalCommunication += communicationMax[it];
+        }
+        std::cout << "[MPI] Tempo impiegato da k-means: " << elapsed_seconds << " secondi (" << iterations
+                  << " iterazioni)" << std::endl;
+        std::cout << "[MPI] Calcolo: " << totalCompute << " s, comunicazione: " << totalCommunication << " s"
+                  << std::endl;
+        for (int c = 0; c < numCluster; c++) {
+            std::cout << "[MPI] Centroide " << c << ": " << x_centroids[c] << " " << y_centroids[c] << std::endl;
+        }
+        if (writeModel(modelPath, makeModel(x_centroids, y_centroids, "mpi", numPoints, iterations))) {
+            std::cout << "[MPI] Modello salvato in " << modelPath << std::endl;
+        }
+    }
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,127 @@
+//
+// K-means distribuito con MPI: ogni processo (rank) ha solo la propria parte del dataset e ne assegna
+// i punti con il kernel SIMD di soa_kernel.h, su blocchi statici per thread come in kmeanSoAParallel.
+// Le somme locali totalX, totalY e count di tutti i rank vengono unite con un solo MPI_Allreduce
+// per iterazione; l'aggiornamento dei centroidi e il test di convergenza sono quindi globali
+// e identici su ogni rank.
+//
+
+#ifndef KMEANS_KMEANS_MPI_H
+#define KMEANS_KMEANS_MPI_H
+
+#include <algorithm>
+#include <iostream>
+#include <span>
+#include <tuple>
+#include <vector>
+#include <mpi.h>
+#include <omp.h>
+#include "soa_kmeans.h"
+
+// Tempi di una iterazione su un rank: assegnazione locale e MPI_Allreduce.
+// Il tempo di comunicazione comprende anche l'attesa dei rank più lenti
+struct mpiIterationTimes {
+    double compute;
+    double communication;
+};
+
+// x_values, y_values: punti di questo rank. I centroidi iniziali devono essere uguali su tutti i rank.
+// Ritorna centroidi e cluster dei punti locali; times riceve i tempi di ogni iterazione
+inline std::tuple<std::vector<double>, std::vector<double>, std::vector<int>>
+kmeanMPI(std::vector<double> &x_centroids, std::vector<double> &y_centroids,
+         std::span<const double> x_values, std::span<const double> y_values,
+         int numCluster, int maxIter, MPI_Comm comm, int *iterations = nullptr,
+         std::vector<mpiIterationTimes> *times = nullptr) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    std::vector<int> points_id(x_values.size(), -1);
+
+    // Accumulatori locali dei thread, come in kmeanSoAParallel
+    int numThreads = omp_get_max_threads();
+    int strideSums = (numCluster + 7) / 8 * 8 + 8;
+    int strideCount = (numCluster + 15) / 16 * 16 + 16;
+    std::vector<double> localX(numThreads * strideSums);
+    std::vector<double> localY(numThreads * strideSums);
+    std::vector<int> localCount(numThreads * strideCount);
+    std::size_t strideScratch = (assignScratchSize(numCluster) + 7) / 8 * 8 + 8;
+    std::vector<double> laneScratch(numThreads * strideScratch, 0.0);
+
+    std::vector<std::size_t> bounds = chunkBounds(points_id, numThreads);
+
+    // Buffer inviato a MPI_Allreduce: [totalX | totalY | count | punti cambiati].
+    // I conteggi sono double (esatti fino a 2^53) per sommare tutto con una sola chiamata
+    std::vector<double> totals(3 * numCluster + 1);
+
+    bool centerUpdated;
+    int i = 0;
+
+    const char *kernelName;
+    assignKernel assign = selectAssignKernel(&kernelName);
+    if (rank == 0) {
+        std::cout << "[MPI] Kernel di assegnazione: " << kernelName << std::endl;
+    }
+
+    do {
+        if (i % 10 == 0 && rank == 0)
+            std::cout << "[MPI] Numero iterazioni k-means: " << i << std::endl;
+        i++;
+
+        double computeStart = MPI_Wtime();
+        bool localUpdated = false;
+
+#pragma omp parallel num_threads(numThreads) reduction(||:localUpdated)
+        {
+            int t = omp_get_thread_num();
+            double *sumX = &localX[t * strideSums];
+            double *sumY = &localY[t * strideSums];
+            int *count = &localCount[t * strideCount];
+
+            std::fill(sumX, sumX + numCluster, 0.0);
+            std::fill(sumY, sumY + numCluster, 0.0);
+            std::fill(count, count + numCluster, 0);
+
+            for (int c = t; c < numThreads; c += omp_get_num_threads()) {
+                localUpdated = assign(x_values.data(), y_values.data(), points_id.data(), bounds[c], bounds[c + 1],
+                                      x_centroids.data(), y_centroids.data(), numCluster,
+                                      sumX, sumY, count, &laneScratch[t * strideScratch]) || localUpdated;
+            }
+        }
+
+        std::fill(totals.begin(), totals.end(), 0.0);
+        for (int t = 0; t < numThreads; t++) {
+            for (int w = 0; w < numCluster; ++w) {
+                totals[w] += localX[t * strideSums + w];
+                totals[numCluster + w] += localY[t * strideSums + w];
+                totals[2 * numCluster + w] += localCount[t * strideCount + w];
+            }
+        }
+        totals[3 * numCluster] = localUpdated ? 1 : 0;
+
+        double communicationStart = MPI_Wtime();
+        MPI_Allreduce(MPI_IN_PLACE, totals.data(), static_cast<int>(totals.size()), MPI_DOUBLE, MPI_SUM, comm);
+        double communicationEnd = MPI_Wtime();
+        if (times) {
+            times->push_back({communicationStart - computeStart, communicationEnd - communicationStart});
+        }
+
+        // Aggiornamento globale: tutti i rank hanno le stesse somme e calcolano gli stessi centroidi
+        centerUpdated = totals[3 * numCluster] > 0;
+        if (centerUpdated) {
+            for (int w = 0; w < numCluster; ++w) {
+                double count = totals[2 * numCluster + w];
+                if (count > 0) {
+                    x_centroids[w] = totals[w] / count;
+                    y_centroids[w] = totals[numCluster + w] / count;
+                }
+            }
+        }
+    } while (centerUpdated && i <= maxIter);
+
+    if (iterations) {
+        *iterations = i;
+    }
+    return std::make_tuple(x_centroids, y_centroids, points_id);
+}
+
+#endif // KMEANS_KMEANS_MPI_H
@@ -0,0 +1,87 @@
+//
+// K-means su dati a D dimensioni (una riga di coordinate per punto), senza grafica.
+// La dimensione viene letta dalla prima riga del file.
+//
+// Uso: kmeans_nd [dataset] [cluster] [iterazioni massime] [modello]
+// I centroidi iniziali vengono da ../dataset/centroids.txt se ha la stessa dimensione dei dati,
+// altrimenti sono punti del dataset scelti a caso.
+//
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <chrono>
+#include "dataset_parser.h"
+#include "kmeans_nd.h"
+#include "model.h"
+
+std::vector<double> initialCentroids(const std::vector<double> &points, int dim, int numCluster) {
+    std::vector<double> centroids;
+    if (datasetDimension("../dataset/centroids.txt") == dim &&
+        parseDatasetRows("../dataset/centroids.txt", dim, centroids) &&
+        centroids.size() >= static_cast<std::size_t>(numCluster) * dim) {
+        centroids.resize(static_cast<std::size_t>(numCluster) * dim);
+        return centroids;
+    }
+
+    std::cout << "[ND] Centroidi iniziali scelti a caso tra i punti" << std::endl;
+    std::mt19937_64 gen(std::random_device{}());
+    std::uniform_int_distribution<std::size_t> pick(0, points.size() / dim - 1);
+    centroids.clear();
+    for (int c = 0; c < numCluster; c++) {
+        std::size_t p = pick(gen);
+        centroids.insert(centroids.end(), points.begin() + p * dim, points.begin() + (p + 1) * dim);
+    }
+    return centroids;
+}
+
+int main(int argc, char *argv[]) {
+    std::string path = argc > 1 ? argv[1] : "../dataset/dataset.txt";
+    int numCluster = argc > 2 ? std::stoi(argv[2]) : 10;
+    int maxIter = argc > 3 ? std::stoi(argv[3]) : 150;
+    std::string modelPath = argc > 4 ? argv[4] : "../dataset/model.kmm";
+
+    std::cout << "[ND] Versione kmeans a D dimensioni\n" << std::endl;
+
+    int dim = datasetDimension(path);
+    if (dim < 0) {
+        std::cerr << "[ND] Il file ha più di " << maxParsedDimension << " coordinate per riga" << std::endl;
+        return 1;
+    }
+    std::vector<double> points;
+    if (dim == 0 || !parseDatasetRows(path, dim, points) || points.empty()) {
+        std::cerr << "[ND] Errore nell'apertura del file" << std::endl;
+        return 1;
+    }
+    std::size_t numPoints = points.size() / dim;
+    std::cout << "[ND] Punti caricati: " << numPoints << " in " << dim << " dimensioni" << std::endl;
+
+    std::vector<double> centroids = initialCentroids(points, dim, numCluster);
+    std::vector<int> labels;
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    int iterations = kmeanAnyDimension(points.data(), numPoints, dim, centroids, labels, maxIter);
+    std::chrono::duration<double> elapsed_seconds = std::chrono::steady_clock::now() - start_time;
+    std::cout << "[ND] Tempo impiegato da k-means: " << elapsed_seconds.count() << " secondi (" << iterations
+              << " iterazioni)" << std::endl;
+
+    for (int c = 0; c < numCluster; c++) {
+        std::cout << "[ND] Centroide " << c << ":";
+        for (int j = 0; j < dim; j++) {
+            std::cout << " " << centroids[c * dim + j];
+        }
+        std::cout << std::endl;
+    }
+
+    kmeansModel model;
+    model.dimension = dim;
+    model.numCluster = numCluster;
+    model.iterations = iterations;
+    model.trainPoints = numPoints;
+    model.source = "nd";
+    model.centroids = centroids;
+    if (writeModel(modelPath, model)) {
+        std::cout << "[ND] Modello salvato in " << modelPath << std::endl;
+    }
+    return 0;
+}
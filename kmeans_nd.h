@@ -0,0 +1,157 @@
+//
+// K-means in D dimensioni. I punti sono righe di D coordinate contigue (row-major) e la dimensione è un
+// parametro del template: con D noto a compile time i cicli sulle coordinate hanno un numero fisso di passi
+// e il compilatore li srotola e vettorizza. D = dynamicDimension usa la dimensione passata a runtime.
+// Assegnazione e aggiornamento seguono kmean di parallel.cpp: somme parziali per thread e riduzione ad albero.
+//
+
+#ifndef KMEANS_KMEANS_ND_H
+#define KMEANS_KMEANS_ND_H
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+const int dynamicDimension = 0;
+
+// Distanza al quadrato tra due righe: basta per confrontare le distanze ed evita la radice
+template<int D>
+inline double squaredDistanceND(const double *a, const double *b, int dim) {
+    const int d = D > 0 ? D : dim;
+    double sum = 0;
+    for (int j = 0; j < d; j++) {
+        double diff = a[j] - b[j];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+// Per D = 2 la somma è scritta per esteso, con lo stesso ordine delle operazioni delle versioni 2D
+template<>
+inline double squaredDistanceND<2>(const double *a, const double *b, int) {
+    return (a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]);
+}
+
+// points: numPoints righe di dim coordinate; centroids: numClusters righe, aggiornate sul posto;
+// labels: cluster di ogni punto (-1 all'inizio). Ritorna il numero di iterazioni eseguite
+template<int D>
+int kmeanND(const double *points, std::size_t numPoints, int dim, std::vector<double> &centroids,
+            std::vector<int> &labels, int maxIter) {
+    static_assert(D >= 0, "La dimensione deve essere positiva, o dynamicDimension");
+    const int d = D > 0 ? D : dim;
+    const int numClusters = centroids.size() / d;
+    labels.assign(numPoints, -1);
+
+    int numThreads = 1;
+#ifdef _OPENMP
+    numThreads = omp_get_max_threads();
+#endif
+    // Blocchi di somme per thread distanziati di almeno una linea di cache (false sharing)
+    const std::size_t sumStride = (static_cast<std::size_t>(numClusters) * d + 7) / 8 * 8 + 8;
+    const std::size_t countStride = (numClusters + 15) / 16 * 16 + 16;
+    std::vector<double> sums(numThreads * sumStride);
+    std::vector<long long> counts(numThreads * countStride);
+    std::vector<double> current(centroids);
+
+    bool centerUpdated;
+    int i = 0;
+    do {
+        centerUpdated = false;
+        if (i % 10 == 0)
+            std::cout << "[ND] Numero iterazioni k-means: " << i << std::endl;
+        i++;
+
+        current = centroids;
+
+#pragma omp parallel reduction(||:centerUpdated) num_threads(numThreads)
+        {
+            int threads = 1;
+            int t = 0;
+#ifdef _OPENMP
+            threads = omp_get_num_threads();
+            t = omp_get_thread_num();
+#endif
+            double *localSums = &sums[t * sumStride];
+            long long *localCounts = &counts[t * countStride];
+            std::fill(localSums, localSums + static_cast<std::size_t>(numClusters) * d, 0.0);
+            std::fill(localCounts, localCounts + numClusters, 0);
+
+            // Assegnazione dei punti ai cluster più vicini
+#pragma omp for schedule(static)
+            for (std::size_t p = 0; p < numPoints; p++) {
+                const double *row = points + p * d;
+                int minIndex = 0;
+                double minDist = INFINITY;
+                for (int c = 0; c < numClusters; c++) {
+                    double dist = squaredDistanceND<D>(row, &current[c * d], d);
+                    if (dist < minDist) {
+                        minDist = dist;
+                        minIndex = c;
+                    }
+                }
+
+                if (labels[p] != minIndex) {
+                    centerUpdated = true;
+                    labels[p] = minIndex;
+                }
+                double *target = localSums + minIndex * d;
+                for (int j = 0; j < d; j++) {
+                    target[j] += row[j];
+                }
+                localCounts[minIndex]++;
+            }
+
+            // Riduzione ad albero delle somme parziali, il risultato finisce nel blocco del thread 0
+            for (int stride = 1; stride < threads; stride *= 2) {
+                if (t % (2 * stride) == 0 && t + stride < threads) {
+                    const double *otherSums = &sums[(t + stride) * sumStride];
+                    const long long *otherCounts = &counts[(t + stride) * countStride];
+                    for (int k = 0; k < numClusters * d; k++) {
+                        localSums[k] += otherSums[k];
+                    }
+                    for (int c = 0; c < numClusters; c++) {
+                        localCounts[c] += otherCounts[c];
+                    }
+                }
+#pragma omp barrier
+            }
+        }
+
+        // Aggiornamento dei centroidi (i cluster vuoti restano dove sono)
+        for (int c = 0; c < numClusters; c++) {
+            if (counts[c] > 0) {
+                for (int j = 0; j < d; j++) {
+                    centroids[c * d + j] = sums[c * d + j] / counts[c];
+                }
+            }
+        }
+
+    } while (centerUpdated && i <= maxIter);
+
+    return i;
+}
+
+// Sceglie l'istanza del template in base alla dimensione dei dati: 2, 3, 4 e 8 hanno il ciclo srotolato,
+// le altre dimensioni usano la versione a runtime
+inline int kmeanAnyDimension(const double *points, std::size_t numPoints, int dim, std::vector<double> &centroids,
+                              std::vector<int> &labels, int maxIter) {
+    switch (dim) {
+        case 2:
+            return kmeanND<2>(points, numPoints, dim, centroids, labels, maxIter);
+        case 3:
+            return kmeanND<3>(points, numPoints, dim, centroids, labels, maxIter);
+        case 4:
+            return kmeanND<4>(points, numPoints, dim, centroids, labels, maxIter);
+        case 8:
+            return kmeanND<8>(points, numPoints, dim, centroids, labels, maxIter);
+        default:
+            return kmeanND<dynamicDimension>(points, numPoints, dim, centroids, labels, maxIter);
+    }
+}
+
+#endif // KMEANS_KMEANS_ND_H
@@ -0,0 +1,65 @@
+//
+// K-means con più restart sullo stesso dataset, senza grafica: il file viene letto una volta sola e
+// tutti i restart avanzano insieme (restarts.h). Viene tenuto il risultato con l'inerzia minore.
+//
+// Uso: kmeans_restarts [dataset] [cluster] [restart] [iterazioni massime] [seme] [modello]
+// Il dataset può essere il file di testo o quello binario di convert_dataset.
+//
+
+#include <chrono>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+#include "dataset_binary.h"
+#include "model.h"
+#include "restarts.h"
+
+int main(int argc, char *argv[]) {
+    std::string path = argc > 1 ? argv[1] : "../dataset/dataset.txt";
+    int numCluster = argc > 2 ? std::stoi(argv[2]) : 10;
+    int numRestarts = argc > 3 ? std::stoi(argv[3]) : 8;
+    int maxIter = argc > 4 ? std::stoi(argv[4]) : 150;
+    unsigned long long seed = argc > 5 ? std::stoull(argv[5]) : 1;
+    std::string modelPath = argc > 6 ? argv[6] : "../dataset/model.kmm";
+
+    std::cout << "[Restart] Versione kmeans con " << numRestarts << " restart\n" << std::endl;
+
+    std::chrono::steady_clock::time_point load_start = std::chrono::steady_clock::now();
+    datasetColumns dataset;
+    if (!dataset.load(path)) {
+        std::cerr << "[Restart] Errore nell'apertura del file" << std::endl;
+        return 1;
+    }
+    std::span<const double> x_values = dataset.x, y_values = dataset.y;
+    std::chrono::duration<double> load_seconds = std::chrono::steady_clock::now() - load_start;
+    std::cout << "[Restart] Punti caricati: " << x_values.size() << " in " << load_seconds.count() << " secondi"
+              << std::endl;
+
+    int best = 0;
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    std::vector<restartResult> results = kmeanRestarts(x_values, y_values, numCluster, numRestarts, maxIter, seed,
+                                                       &best);
+    std::chrono::duration<double> elapsed_seconds = std::chrono::steady_clock::now() - start_time;
+
+    for (std::size_t r = 0; r < results.size(); r++) {
+        std::cout << "[Restart] Restart " << r << " (seme " << results[r].seed << "): " << results[r].iterations
+                  << " iterazioni, inizializzazione " << results[r].seedingSeconds << " s, k-means "
+                  << results[r].seconds << " s, inerzia " << results[r].inertia
+                  << (static_cast<int>(r) == best ? " <- migliore" : "") << std::endl;
+    }
+    std::cout << "[Restart] Tempo totale: " << elapsed_seconds.count() << " secondi" << std::endl;
+
+    if (!results.empty()) {
+        for (int c = 0; c < numCluster; c++) {
+            std::cout << "[Restart] Centroide " << c << ": " << results[best].x_centroids[c] << " "
+                      << results[best].y_centroids[c] << std::endl;
+        }
+        const restartResult &run = results[best];
+        if (writeModel(modelPath, makeModel(run.x_centroids, run.y_centroids, "restarts", x_values.size(),
+                                            run.iterations, run.inertia))) {
+            std::cout << "[Restart] Modello salvato in " << modelPath << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+//
+// K-means in streaming, senza grafica: legge i punti da stdin (una riga "x y" per punto, ad esempio da una
+// pipe) e aggiorna i centroidi a ogni punto (streaming.h). Ogni tanti punti scrive su stdout un'istantanea
+// dei centroidi come riga JSON; i messaggi vanno su stderr, così stdout può essere passato a un altro programma.
+//
+// Uso: kmeans_stream [cluster] [finestra] [punti per istantanea]
+// finestra: 0 per nessuna finestra, N per gli ultimi N punti, Ns per i punti degli ultimi N secondi.
+// La latenza riportata va dalla lettura della riga all'aggiornamento del centroide.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "dataset_parser.h"
+#include "streaming.h"
+
+// Finestra dalla riga di comando. Ritorna false se il formato non è valido
+bool parseWindow(const std::string &text, streamWindow &window) {
+    try {
+        if (!text.empty() && text.back() == 's') {
+            window.kind = windowKind::time;
+            window.seconds = std::stod(text.substr(0, text.size() - 1));
+            return window.seconds > 0;
+        }
+        long long points = std::stoll(text);
+        window.kind = points > 0 ? windowKind::count : windowKind::none;
+        window.points = static_cast<std::size_t>(std::max(points, 0LL));
+        return true;
+    } catch (const std::exception &) {
+        return false;
+    }
+}
+
+// elapsed è anche l'istante dell'istantanea: con la finestra temporale i punti scaduti vengono tolti prima
+void writeSnapshot(streamingKmeans &stream, long long points, double elapsed, double latencySum,
+                   double latencyMax, long long latencyCount) {
+    stream.expire(elapsed);
+    std::cout << "{\"points\": " << points << ", \"elapsed_s\": " << elapsed
+              << ", \"window_points\": " << stream.windowPoints()
+              << ", \"latency_us_mean\": " << (latencyCount > 0 ? latencySum / latencyCount * 1e6 : 0)
+              << ", \"latency_us_max\": " << latencyMax * 1e6 << ", \"centroids\": [";
+    bool first = true;
+    for (auto &c: stream.getClusters()) {
+        point centroid = c.getCentroid();
+        std::cout << (first ? "" : ", ") << "[" << centroid.x << ", " << centroid.y << ", " << c.getCount() << "]";
+        first = false;
+    }
+    std::cout << "]}" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    int numCluster = argc > 1 ? std::stoi(argv[1]) : 10;
+    std::string windowText = argc > 2 ? argv[2] : "0";
+    long long snapshotEvery = argc > 3 ? std::stoll(argv[3]) : 100000;
+
+    streamWindow window;
+    if (numCluster <= 0 || snapshotEvery <= 0 || !parseWindow(windowText, window)) {
+        std::cerr << "[Stream] Uso: kmeans_stream [cluster] [finestra: 0 | N | Ns] [punti per istantanea]"
+                  << std::endl;
+        return 1;
+    }
+    std::cerr << "[Stream] Versione kmeans in streaming, " << numCluster << " cluster, finestra: "
+              << (window.kind == windowKind::none ? "nessuna" : windowText) << std::endl;
+
+    std::ios::sync_with_stdio(false);
+    streamingKmeans stream(numCluster, window);
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    long long points = 0, skipped = 0;
+    double latencySum = 0, latencyMax = 0;
+    long long latencyCount = 0;
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::chrono::steady_clock::time_point arrival = std::chrono::steady_clock::now();
+        const char *end = line.data() + line.size();
+        double x, y;
+        const char *p = parseNumber(line.data(), end, x);
+        if (!p || !parseNumber(p, end, y)) {
+            skipped++;
+            continue;
+        }
+        stream.add(x, y, std::chrono::duration<double>(arrival - start_time).count());
+        double latency = std::chrono::duration<double>(std::chrono::steady_clock::now() - arrival).count();
+        latencySum += latency;
+        latencyMax = std::max(latencyMax, latency);
+        latencyCount++;
+
+        if (++points % snapshotEvery == 0) {
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+            writeSnapshot(stream, points, elapsed, latencySum, latencyMax, latencyCount);
+            latencySum = latencyMax = 0;
+            latencyCount = 0;
+        }
+    }
+
+    stream.flush(); // stream più corto dei punti per i centroidi iniziali
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    if (points % snapshotEvery != 0) {
+        writeSnapshot(stream, points, elapsed, latencySum, latencyMax, latencyCount);
+    }
+    std::cerr << "[Stream] Punti elaborati: " << points << " in " << elapsed << " secondi ("
+              << (elapsed > 0 ? points / elapsed : 0) << " punti/s), righe non valide: " << skipped << std::endl;
+    return 0;
+}
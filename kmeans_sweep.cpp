@@ -0,0 +1,60 @@
+//
+// Scelta del numero di cluster, senza grafica: k-means viene eseguito per ogni K tra K minimo e K massimo
+// in un'unica invocazione (k_selection.h) e per ognuno vengono stampate inerzia e silhouette.
+// Al termine vengono suggeriti il K del gomito dell'inerzia e quello con la silhouette più alta.
+//
+// Uso: kmeans_sweep [dataset] [K minimo] [K massimo] [iterazioni massime] [seme]
+// Il dataset può essere il file di testo o quello binario di convert_dataset.
+//
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "dataset_binary.h"
+#include "k_selection.h"
+
+int main(int argc, char *argv[]) {
+    std::string path = argc > 1 ? argv[1] : "../dataset/dataset.txt";
+    int kMin = argc > 2 ? std::stoi(argv[2]) : 2;
+    int kMax = argc > 3 ? std::stoi(argv[3]) : 20;
+    int maxIter = argc > 4 ? std::stoi(argv[4]) : 150;
+    unsigned long long seed = argc > 5 ? std::stoull(argv[5]) : 1;
+
+    std::cout << "[Sweep] Scelta di K tra " << kMin << " e " << kMax << "\n" << std::endl;
+
+    std::chrono::steady_clock::time_point load_start = std::chrono::steady_clock::now();
+    datasetColumns dataset;
+    if (!dataset.load(path)) {
+        std::cerr << "[Sweep] Errore nell'apertura del file" << std::endl;
+        return 1;
+    }
+    std::chrono::duration<double> load_seconds = std::chrono::steady_clock::now() - load_start;
+    std::cout << "[Sweep] Punti caricati: " << dataset.x.size() << " in " << load_seconds.count() << " secondi"
+              << std::endl;
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    std::vector<sweepResult> sweep = kmeanSweep(dataset.x, dataset.y, kMin, kMax, maxIter, seed);
+    std::chrono::duration<double> elapsed_seconds = std::chrono::steady_clock::now() - start_time;
+    if (sweep.empty()) {
+        std::cerr << "[Sweep] Intervallo di K non valido" << std::endl;
+        return 1;
+    }
+
+    const sweepResult *bestSilhouette = &sweep.front();
+    std::cout << "[Sweep] K, iterazioni, tempo k-means (s), inerzia, silhouette" << std::endl;
+    for (const sweepResult &s: sweep) {
+        std::cout << "[Sweep] " << std::setw(3) << s.numCluster << " " << std::setw(4) << s.run.iterations << " "
+                  << std::setw(10) << s.run.seconds << " " << std::setw(12) << s.inertia << " "
+                  << std::setw(10) << s.silhouette << std::endl;
+        if (s.silhouette > bestSilhouette->silhouette) {
+            bestSilhouette = &s;
+        }
+    }
+    std::cout << "[Sweep] Tempo totale: " << elapsed_seconds.count() << " secondi (k-means++ "
+              << sweep.front().run.seedingSeconds << " s)" << std::endl;
+    std::cout << "[Sweep] K suggerito dal gomito dell'inerzia: " << elbowCluster(sweep) << std::endl;
+    std::cout << "[Sweep] K suggerito dalla silhouette: " << bestSilhouette->numCluster << std::endl;
+    return 0;
+}
@@ -0,0 +1,350 @@
+//
+// Algoritmo di Lloyd sui tipi di kmeans.h: versione sequenziale e versione OpenMP con somme
+// parziali per thread. Usate dai programmi con grafica e dal benchmark.
+//
+// refreshPeriod ha lo stesso significato che in soa_kmeans.h: 0 ricalcola le somme dei cluster a ogni
+// iterazione, n > 0 aggiorna solo i cluster dei punti che si spostano e ricalcola tutto ogni n iterazioni.
+// Con telemetry diverso da nullptr ogni iterazione scrive una riga di statistiche (telemetry.h).
+// Da blockedMinClusters cluster in su l'assegnazione usa il buffer contiguo e i pannelli di blocked_assign.h.
+//
+
+#ifndef KMEANS_LLOYD_H
+#define KMEANS_LLOYD_H
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <omp.h>
+#include "blocked_assign.h"
+#include "kmeans.h"
+#include "telemetry.h"
+
+inline std::vector<cluster> kmeanSequential(std::vector<cluster> &clusters, std::vector<point> &points, int maxIter,
+                                            int *iterations = nullptr, int refreshPeriod = 0,
+                                            telemetryLog *telemetry = nullptr) {
+    bool centerUpdated;
+    int minIndex;
+    double minDist;
+    double dist;
+    int i = 0;
+    iterationStats stats;
+    double phaseStart = 0;
+    int numClusters = static_cast<int>(clusters.size());
+    bool blocked = numClusters >= blockedMinClusters;
+    centroidBuffer buffer;
+    std::unique_ptr<panelScratch> scratch = blocked ? std::make_unique<panelScratch>() : nullptr;
+
+    // Sposta il punto nel cluster minIndex e aggiorna le somme (squaredDist: distanza al quadrato)
+    auto place = [&](point &p, int minIndex, double squaredDist, bool full) {
+        bool moved = p.clusterID != minIndex;
+        if (moved) {
+            centerUpdated = true; // Se nessun punto cambia cluster allora termino
+            stats.moved++;
+        }
+        if (telemetry) {
+            stats.inertia += squaredDist;
+        }
+        if (full || moved) {
+            if (!full && p.clusterID >= 0) {
+                clusters[p.clusterID].addTotals(-p.x, -p.y, -1);
+            }
+            clusters[minIndex].addTotalX(p.x);
+            clusters[minIndex].addTotalY(p.y);
+            clusters[minIndex].countPoints();
+        }
+        p.clusterID = minIndex;
+    };
+
+    do {
+        centerUpdated = false;
+        if (i % 10 == 0)
+            std::cout << "[Seq] Numero iterazioni k-means: " << i << std::endl;
+        i++;
+
+        if (telemetry) {
+            stats = iterationStats{};
+            stats.iteration = i;
+            phaseStart = omp_get_wtime();
+        }
+
+        // Con l'aggiornamento incrementale le somme restano quelle dell'iterazione precedente
+        bool full = refreshPeriod <= 0 || (i - 1) % refreshPeriod == 0;
+        for (auto &cluster: clusters) {
+            if (full) {
+                // reset valori in ogni cluster
+                cluster.resetTotalX();
+                cluster.resetTotalY();
+                cluster.resetCountPoints();
+            }
+        }
+
+        if (telemetry) {
+            double now = omp_get_wtime();
+            stats.resetSeconds = now - phaseStart;
+            phaseStart = now;
+        }
+
+        if (blocked) {
+            buffer.pack(clusters);
+            for (std::size_t begin = 0; begin < points.size(); begin += panelPoints) {
+                std::size_t n = std::min(panelPoints, points.size() - begin);
+                assignPanel(points.data() + begin, n, buffer, *scratch);
+                for (std::size_t j = 0; j < n; j++) {
+                    place(points[begin + j], scratch->nearest[j], scratch->nearestDist[j], full);
+                }
+            }
+        } else {
+            for (auto &point: points) {
+                minDist = INFINITY;
+                for (int j = 0; j < numClusters; j++) {
+                    dist = std::sqrt(std::pow(clusters[j].getCentroid().x - point.x, 2) + std::pow(clusters[j].getCentroid().y - point.y, 2));
+                    if (dist < minDist) {
+                        minDist = dist;
+                        minIndex = j;
+                    }
+                }
+                place(point, minIndex, minDist * minDist, full);
+            }
+        }
+
+        if (telemetry) {
+            double now = omp_get_wtime();
+            stats.assignSeconds = now - phaseStart;
+            phaseStart = now;
+        }
+
+        if (centerUpdated) {
+            for (auto &cluster: clusters) {
+                point previous = cluster.getCentroid();
+                cluster.updateCentroid();
+                stats.maxShift = std::max(stats.maxShift, pointDistance(previous, cluster.getCentroid()));
+            }
+        }
+
+        if (telemetry) {
+            stats.updateSeconds = omp_get_wtime() - phaseStart;
+            stats.threadMin = stats.assignSeconds;
+            stats.threadMax = stats.assignSeconds;
+            telemetry->write(stats);
+        }
+    } while (centerUpdated && i <= maxIter);
+
+    if (iterations) {
+        *iterations = i;
+    }
+    return clusters;
+}
+
+// Somme parziali di un thread per un cluster. L'allineamento alla linea di cache (64 byte)
+// evita che thread diversi scrivano sulla stessa linea (false sharing)
+struct alignas(64) partialSum {
+    double totalX = 0;
+    double totalY = 0;
+    int count = 0;
+};
+
+// Il vettore dei punti può usare un allocatore diverso da quello standard, ad esempio
+// firstTouchAllocator di numa_placement.h per i punti già distribuiti sui nodi NUMA
+template<typename PointAllocator>
+std::vector<cluster> kmeanParallel(std::vector<cluster> &clusters, std::vector<point, PointAllocator> &points,
+                                   int maxIter, int *iterations = nullptr, omp_sched_t schedule = omp_sched_static,
+                                   int chunkSize = 0, int refreshPeriod = 0, telemetryLog *telemetry = nullptr) {
+    bool centerUpdated;
+    int i = 0;
+    int numClusters = clusters.size();
+    iterationStats stats;
+
+    // Tempi del thread 0 e tempi di assegnazione di ogni thread, usati solo dalla telemetria.
+    // teamSize è il numero di thread della regione di assegnazione, che può essere minore del massimo
+    double iterationStart = 0, assignStart = 0, assignEnd = 0;
+    std::vector<double> threadSeconds(omp_get_max_threads());
+    int teamSize = 1;
+
+    // Un blocco di somme parziali per ogni thread: durante l'assegnazione ogni thread
+    // scrive solo nel proprio blocco, quindi non servono atomic. Ogni blocco viene allocato
+    // e scritto per primo dal thread che lo usa, quindi sta nella memoria del suo nodo NUMA.
+    // L'allocazione avviene nella regione dell'assegnazione, alla prima iterazione in cui il thread
+    // esiste: una regione separata potrebbe avere un numero di thread diverso
+    std::vector<std::unique_ptr<partialSum[]>> partials(omp_get_max_threads());
+    // Memoria di lavoro dei pannelli, allocata allo stesso modo alla prima iterazione di ogni thread
+    std::vector<std::unique_ptr<panelScratch>> scratch(omp_get_max_threads());
+    std::vector<point> centroids(numClusters);
+    bool blocked = numClusters >= blockedMinClusters;
+    centroidBuffer buffer;
+    int numPoints = static_cast<int>(points.size());
+    long long numPanels = (static_cast<long long>(points.size()) + panelPoints - 1) / panelPoints;
+
+    // Il ciclo di assegnazione usa schedule(runtime). omp_set_schedule cambia la politica per tutto il
+    // thread chiamante, quindi quella precedente viene salvata e ripristinata prima di uscire
+    omp_sched_t previousSchedule;
+    int previousChunkSize;
+    omp_get_schedule(&previousSchedule, &previousChunkSize);
+    omp_set_schedule(schedule, chunkSize);
+
+    do {
+        centerUpdated = false;
+        if (i % 10 == 0)
+            std::cout << "[Par] Numero iterazioni k-means: " << i << std::endl;
+        i++;
+
+        if (telemetry) {
+            iterationStart = omp_get_wtime();
+        }
+        long long movedPoints = 0;
+        double inertia = 0;
+
+        // Con l'aggiornamento incrementale le somme parziali contengono solo le variazioni dell'iterazione
+        bool full = refreshPeriod <= 0 || (i - 1) % refreshPeriod == 0;
+
+        for (int c = 0; c < numClusters; c++) {
+            centroids[c] = clusters[c].getCentroid();
+        }
+        if (blocked) {
+            buffer.pack(clusters);
+        }
+
+#pragma omp parallel reduction(+:movedPoints, inertia)
+        {
+            int numThreads = omp_get_num_threads();
+            int t = omp_get_thread_num();
+            if (!partials[t]) {
+                partials[t] = std::make_unique<partialSum[]>(numClusters);
+            }
+            partialSum *local = partials[t].get();
+
+            // Reset delle somme parziali del thread
+            for (int c = 0; c < numClusters; c++) {
+                local[c] = partialSum{};
+            }
+
+            double threadStart = telemetry ? omp_get_wtime() : 0;
+            if (telemetry && t == 0) {
+                assignStart = threadStart;
+                teamSize = numThreads;
+            }
+
+            // Sposta il punto p nel cluster minIndex e aggiorna le somme del thread
+            auto place = [&](int p, int minIndex, double squaredDist) {
+                int previous = points[p].clusterID;
+                if (previous != minIndex) {
+                    movedPoints++; // ridotto in somma tra i thread
+                }
+                if (telemetry) {
+                    inertia += squaredDist;
+                }
+                points[p].clusterID = minIndex;
+                if (full || previous != minIndex) {
+                    if (!full && previous >= 0) {
+                        local[previous].totalX -= points[p].x;
+                        local[previous].totalY -= points[p].y;
+                        local[previous].count--;
+                    }
+                    local[minIndex].totalX += points[p].x;
+                    local[minIndex].totalY += points[p].y;
+                    local[minIndex].count++;
+                }
+            };
+
+            // Assegnazione dei punti ai cluster più vicini. La barriera è esplicita per poter misurare
+            // il tempo di ogni thread prima dell'attesa degli altri. Con K grande il ciclo scorre
+            // pannelli di panelPoints punti invece dei singoli punti (anche per il chunk di schedule)
+            if (blocked) {
+                if (!scratch[t]) {
+                    scratch[t] = std::make_unique<panelScratch>();
+                }
+                panelScratch &panel = *scratch[t];
+#pragma omp for schedule(runtime) nowait
+                for (long long b = 0; b < numPanels; b++) {
+                    std::size_t begin = b * panelPoints;
+                    std::size_t n = std::min(panelPoints, points.size() - begin);
+                    assignPanel(points.data() + begin, n, buffer, panel);
+                    for (std::size_t j = 0; j < n; j++) {
+                        place(static_cast<int>(begin + j), panel.nearest[j], panel.nearestDist[j]);
+                    }
+                }
+            } else {
+                int minIndex;
+                double minDist;
+                double dist;
+#pragma omp for schedule(runtime) nowait
+                for (int p = 0; p < numPoints; p++) {
+                    minIndex = -1;
+                    minDist = INFINITY;
+
+                    for (int c = 0; c < numClusters; c++) {
+                        dist = std::sqrt(std::pow(centroids[c].x - points[p].x, 2) +
+                                         std::pow(centroids[c].y - points[p].y, 2));
+                        if (dist < minDist) {
+                            minDist = dist;
+                            minIndex = c;
+                        }
+                    }
+                    place(p, minIndex, minDist * minDist);
+                }
+            }
+
+            if (telemetry) {
+                threadSeconds[t] = omp_get_wtime() - threadStart;
+            }
+#pragma omp barrier
+            if (telemetry && t == 0) {
+                assignEnd = omp_get_wtime();
+            }
+
+            // Riduzione ad albero delle somme parziali: al passo stride il thread t accumula
+            // il blocco del thread t + stride. Al termine il risultato è nel blocco del thread 0
+            for (int stride = 1; stride < numThreads; stride *= 2) {
+                if (t % (2 * stride) == 0 && t + stride < numThreads) {
+                    partialSum *other = partials[t + stride].get();
+                    for (int c = 0; c < numClusters; c++) {
+                        local[c].totalX += other[c].totalX;
+                        local[c].totalY += other[c].totalY;
+                        local[c].count += other[c].count;
+                    }
+                }
+#pragma omp barrier
+            }
+        }
+        centerUpdated = movedPoints > 0;
+
+        double updateStart = telemetry ? omp_get_wtime() : 0;
+
+        // Aggiornamento dei centroidi
+        for (int c = 0; c < numClusters; c++) {
+            const partialSum &total = partials[0][c];
+            if (full) {
+                clusters[c].setTotals(total.totalX, total.totalY, total.count);
+            } else {
+                clusters[c].addTotals(total.totalX, total.totalY, total.count);
+            }
+            clusters[c].updateCentroid();
+        }
+
+        if (telemetry) {
+            stats = iterationStats{};
+            stats.iteration = i;
+            stats.resetSeconds = assignStart - iterationStart;
+            stats.assignSeconds = assignEnd - assignStart;
+            stats.reduceSeconds = updateStart - assignEnd;
+            stats.updateSeconds = omp_get_wtime() - updateStart;
+            stats.moved = movedPoints;
+            stats.inertia = inertia;
+            for (int c = 0; c < numClusters; c++) {
+                stats.maxShift = std::max(stats.maxShift, pointDistance(centroids[c], clusters[c].getCentroid()));
+            }
+            threadBalance(threadSeconds, teamSize, stats);
+            telemetry->write(stats);
+        }
+
+    } while (centerUpdated && i <= maxIter);
+
+    omp_set_schedule(previousSchedule, previousChunkSize);
+    if (iterations) {
+        *iterations = i;
+    }
+    return clusters;
+}
+
+#endif // KMEANS_LLOYD_H
@@ -0,0 +1,187 @@
+//
+// K-means mini-batch (Sculley, 2010): i centroidi vengono aggiornati con piccoli blocchi di punti
+// letti dal file mappato, quindi la memoria del programma dipende dalla dimensione del batch e non da
+// quella del dataset (le pagine del file restano nella cache del sistema operativo).
+//
+
+#ifndef KMEANS_MINIBATCH_H
+#define KMEANS_MINIBATCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "dataset_parser.h"
+#include "kmeans.h"
+#include "mapped_file.h"
+
+struct miniBatchParams {
+    int batchSize = 1024;
+    int maxBatches = 2000;
+    double tolerance = 0.01;   // spostamento massimo dei centroidi in un batch sotto cui si considera fermo
+    int patience = 20;         // batch consecutivi sotto tolerance prima di fermarsi
+    bool sampleBatches = true; // true: punti casuali dal file; false: lettura sequenziale a blocchi
+    unsigned long long seed = 1; // seme del campionamento: lo stesso seme ripete gli stessi batch
+};
+
+// Legge batch di punti dal file di testo mappato in memoria, convertendo solo le righe usate.
+// In modalità campionamento ogni punto è una riga scelta a caso, con la stessa probabilità per tutte;
+// in modalità sequenziale le righe vengono lette in ordine e il file riparte dall'inizio alla fine.
+// Le righe vengono convertite con parseChunk: quelle senza due coordinate valide vengono saltate
+class batchReader {
+
+private:
+    mappedFile file;
+    std::size_t position = 0; // inizio della prossima riga in modalità sequenziale
+    bool sample;
+    std::mt19937_64 gen;
+
+    // Riga più corta che può contenere due coordinate: "1 2" senza '\n' finale
+    static constexpr std::size_t minLineBytes = 3;
+    // Tentativi falliti consecutivi dopo cui il file viene considerato senza righe valide
+    static constexpr int maxAttempts = 1 << 20;
+
+    // Fine della riga che inizia in begin, compreso il '\n' se presente
+    std::size_t lineEnd(std::size_t begin) const {
+        const void *newline = std::memchr(file.data() + begin, '\n', file.size() - begin);
+        return newline ? static_cast<const char *>(newline) - file.data() + 1 : file.size();
+    }
+
+    // Converte la riga [begin, end) nel punto i del batch; false se la riga non è valida
+    bool parseLine(std::size_t begin, std::size_t end, std::vector<point> &batch, std::size_t i) const {
+        aosStore<point> store{batch};
+        return parseChunk(file.data() + begin, file.data() + end, i, store) == 1;
+    }
+
+    // Un byte a caso cade in una riga con probabilità proporzionale alla sua lunghezza, quindi la riga
+    // viene tenuta con probabilità minLineBytes / lunghezza: a ogni tentativo tutte le righe hanno
+    // probabilità minLineBytes / dimensione del file, anche la prima e quelle dopo righe lunghe
+    bool sampleLine(std::vector<point> &batch, std::size_t i) {
+        std::uniform_int_distribution<std::size_t> offset(0, file.size() - 1);
+        std::uniform_real_distribution<double> accept(0.0, 1.0);
+        for (int attempt = 0; attempt < maxAttempts; attempt++) {
+            std::size_t byte = offset(gen);
+            std::size_t begin = byte;
+            while (begin > 0 && file.data()[begin - 1] != '\n') {
+                begin--;
+            }
+            std::size_t end = lineEnd(begin);
+            if (accept(gen) * static_cast<double>(end - begin) < minLineBytes && parseLine(begin, end, batch, i)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool nextLine(std::vector<point> &batch, std::size_t i) {
+        // Al più un giro completo del file: se non c'è nessuna riga valida la lettura fallisce
+        for (std::size_t scanned = 0; scanned <= file.size();) {
+            if (position >= file.size()) {
+                position = 0;
+            }
+            std::size_t end = lineEnd(position);
+            bool valid = parseLine(position, end, batch, i);
+            scanned += end - position;
+            position = end;
+            if (valid) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+
+    batchReader(const std::string &path, bool sampleBatches, unsigned long long seed) : sample(sampleBatches),
+                                                                                         gen(seed) {
+        file.open(path);
+    }
+
+    bool isOpen() const {
+        return file.size() > 0;
+    }
+
+    bool next(std::vector<point> &batch, int batchSize) {
+        batch.resize(batchSize);
+        for (int b = 0; b < batchSize; b++) {
+            if (!(sample ? sampleLine(batch, b) : nextLine(batch, b))) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Aggiorna i centroidi batch per batch. Ogni centroide ha il proprio tasso di apprendimento
+// 1 / (punti visti finora dal centroide), tenuto nel conteggio del cluster
+inline std::vector<cluster> kmeanMiniBatch(std::vector<cluster> &clusters, const std::string &path,
+                                           const miniBatchParams &params) {
+    int numClusters = clusters.size();
+    batchReader reader(path, params.sampleBatches, params.seed);
+    if (!reader.isOpen()) {
+        std::cerr << "[Seq] Errore nell'apertura del file" << std::endl;
+        return clusters;
+    }
+
+    for (auto &cluster: clusters) {
+        cluster.resetCountPoints();
+    }
+
+    std::vector<point> batch;
+    std::vector<int> nearest(params.batchSize);
+    std::vector<point> before(numClusters);
+    int stableBatches = 0;
+    int b = 0;
+
+    for (; b < params.maxBatches && stableBatches < params.patience; b++) {
+        if (!reader.next(batch, params.batchSize)) {
+            std::cerr << "[Seq] Errore nella lettura del batch" << std::endl;
+            break;
+        }
+
+        for (int c = 0; c < numClusters; c++) {
+            before[c] = clusters[c].getCentroid();
+        }
+
+        // Assegnazione con i centroidi di inizio batch
+        for (int j = 0; j < params.batchSize; j++) {
+            double minDist = INFINITY;
+            for (int c = 0; c < numClusters; c++) {
+                double dist = pointDistance(before[c], batch[j]);
+                if (dist < minDist) {
+                    minDist = dist;
+                    nearest[j] = c;
+                }
+            }
+        }
+
+        // Passo di gradiente per ogni punto verso il centroide assegnato
+        for (int j = 0; j < params.batchSize; j++) {
+            cluster &target = clusters[nearest[j]];
+            target.countPoints();
+            double eta = 1.0 / target.getCount();
+            point c = target.getCentroid();
+            c.x = (1 - eta) * c.x + eta * batch[j].x;
+            c.y = (1 - eta) * c.y + eta * batch[j].y;
+            target.createCentroid(c);
+        }
+
+        double maxShift = 0;
+        for (int c = 0; c < numClusters; c++) {
+            maxShift = std::max(maxShift, pointDistance(before[c], clusters[c].getCentroid()));
+        }
+        stableBatches = maxShift < params.tolerance ? stableBatches + 1 : 0;
+
+        if (b % 100 == 0)
+            std::cout << "[Seq] Mini-batch " << b << ", spostamento massimo dei centroidi: " << maxShift << std::endl;
+    }
+
+    std::cout << "[Seq] Mini-batch completati: " << b << " (" << static_cast<long long>(b) * params.batchSize
+              << " punti letti)" << std::endl;
+    return clusters;
+}
+
+#endif // KMEANS_MINIBATCH_H
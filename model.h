@@ -0,0 +1,137 @@
+//
+// File del modello addestrato: K centroidi in D dimensioni più qualche dato sull'addestramento, scritto
+// al termine di k-means e letto da predict per assegnare nuovi punti ai cluster senza rieseguire k-means.
+// Intestazione da 64 byte come il dataset binario, seguita dai centroidi in double, una riga per centroide.
+//
+
+#ifndef KMEANS_MODEL_H
+#define KMEANS_MODEL_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "dataset_parser.h"
+#include "kmeans.h"
+
+const char modelMagic[8] = {'K', 'M', 'E', 'A', 'N', 'S', 'M', 'D'};
+const std::uint32_t modelVersion = 1;
+
+// Intestazione del file, little-endian come le macchine su cui gira il programma
+struct modelHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t dimension;     // coordinate per centroide
+    std::uint32_t numCluster;
+    std::uint32_t iterations;    // iterazioni di k-means eseguite
+    std::uint64_t trainPoints;   // punti usati per l'addestramento
+    double inertia;              // somma delle distanze al quadrato dai centroidi, 0 se non calcolata
+    std::int64_t createdAt;      // secondi dal 1970 (UTC)
+    char source[16];             // programma che ha addestrato il modello, terminato da '\0'
+};
+static_assert(sizeof(modelHeader) == 64, "L'intestazione deve occupare 64 byte");
+
+struct kmeansModel {
+    int dimension = 0;
+    int numCluster = 0;
+    int iterations = 0;
+    std::uint64_t trainPoints = 0;
+    double inertia = 0;
+    std::int64_t createdAt = 0;
+    std::string source;
+    std::vector<double> centroids; // numCluster righe da dimension coordinate
+
+    // Coordinata d di ogni centroide, contigua: il formato usato dai kernel SoA
+    std::vector<double> column(int d) const {
+        std::vector<double> values(numCluster);
+        for (int c = 0; c < numCluster; c++) {
+            values[c] = centroids[static_cast<std::size_t>(c) * dimension + d];
+        }
+        return values;
+    }
+};
+
+// Modello 2D dai centroidi SoA
+inline kmeansModel makeModel(const std::vector<double> &x_centroids, const std::vector<double> &y_centroids,
+                             const std::string &source, std::uint64_t trainPoints, int iterations = 0,
+                             double inertia = 0) {
+    kmeansModel model;
+    model.dimension = 2;
+    model.numCluster = static_cast<int>(x_centroids.size());
+    model.iterations = iterations;
+    model.trainPoints = trainPoints;
+    model.inertia = inertia;
+    model.source = source;
+    for (int c = 0; c < model.numCluster; c++) {
+        model.centroids.push_back(x_centroids[c]);
+        model.centroids.push_back(y_centroids[c]);
+    }
+    return model;
+}
+
+// Modello 2D dai centroidi AoS
+inline kmeansModel makeModel(const std::vector<point> &centroids, const std::string &source,
+                             std::uint64_t trainPoints, int iterations = 0, double inertia = 0) {
+    std::vector<double> x_centroids, y_centroids;
+    for (const point &c: centroids) {
+        x_centroids.push_back(c.x);
+        y_centroids.push_back(c.y);
+    }
+    return makeModel(x_centroids, y_centroids, source, trainPoints, iterations, inertia);
+}
+
+// Scrive il modello in path; se createdAt vale 0 viene usata l'ora corrente. Ritorna false in caso di errore
+inline bool writeModel(const std::string &path, const kmeansModel &model) {
+    modelHeader header{};
+    std::memcpy(header.magic, modelMagic, sizeof(modelMagic));
+    header.version = modelVersion;
+    header.dimension = model.dimension;
+    header.numCluster = model.numCluster;
+    header.iterations = model.iterations;
+    header.trainPoints = model.trainPoints;
+    header.inertia = model.inertia;
+    header.createdAt = model.createdAt != 0 ? model.createdAt
+                                            : std::chrono::duration_cast<std::chrono::seconds>(
+                                                      std::chrono::system_clock::now().time_since_epoch()).count();
+    std::strncpy(header.source, model.source.c_str(), sizeof(header.source) - 1);
+
+    std::ofstream outFile(path, std::ios::binary | std::ios::trunc);
+    outFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    outFile.write(reinterpret_cast<const char *>(model.centroids.data()),
+                  static_cast<std::streamsize>(model.centroids.size() * sizeof(double)));
+    return static_cast<bool>(outFile);
+}
+
+// Ritorna false se il file non esiste o non è un modello valido: la dimensione deve essere tra 1 e
+// maxParsedDimension (il massimo che il parser di testo sa leggere) e il file deve contenere tutti i centroidi
+inline bool readModel(const std::string &path, kmeansModel &model) {
+    std::ifstream inFile(path, std::ios::binary);
+    modelHeader header{};
+    if (!inFile.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, modelMagic, sizeof(modelMagic)) != 0 || header.version != modelVersion ||
+        header.dimension == 0 || header.dimension > static_cast<std::uint32_t>(maxParsedDimension) ||
+        header.numCluster == 0) {
+        return false;
+    }
+    std::error_code ec;
+    std::uintmax_t fileSize = std::filesystem::file_size(path, ec);
+    std::uintmax_t centroidBytes = static_cast<std::uintmax_t>(header.numCluster) * header.dimension * sizeof(double);
+    if (ec || fileSize < sizeof(header) || fileSize - sizeof(header) < centroidBytes) {
+        return false;
+    }
+    model.dimension = static_cast<int>(header.dimension);
+    model.numCluster = static_cast<int>(header.numCluster);
+    model.iterations = static_cast<int>(header.iterations);
+    model.trainPoints = header.trainPoints;
+    model.inertia = header.inertia;
+    model.createdAt = header.createdAt;
+    model.source.assign(header.source, strnlen(header.source, sizeof(header.source)));
+    model.centroids.resize(static_cast<std::size_t>(header.numCluster) * header.dimension);
+    return static_cast<bool>(inFile.read(reinterpret_cast<char *>(model.centroids.data()),
+                                         static_cast<std::streamsize>(model.centroids.size() * sizeof(double))));
+}
+
+#endif // KMEANS_MODEL_H
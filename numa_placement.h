@@ -0,0 +1,138 @@
+//
+// Posizionamento dei dati per le macchine NUMA (più socket, ognuno con la propria memoria).
+// Linux assegna una pagina al nodo del thread che la scrive per primo (first touch): se i punti vengono
+// scritti dagli stessi thread, con la stessa divisione statica del ciclo di assegnazione, ogni thread
+// legge soprattutto memoria del proprio nodo. Perché la corrispondenza regga i thread vanno fissati
+// ai core: i thread consecutivi vengono messi sullo stesso nodo, a blocchi, così anche la riduzione ad
+// albero di kmeanParallel unisce prima le somme dello stesso nodo.
+//
+
+#ifndef KMEANS_NUMA_PLACEMENT_H
+#define KMEANS_NUMA_PLACEMENT_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <omp.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Allocatore che non inizializza gli elementi di tipi banali: resize alloca la memoria senza
+// scriverla, così le pagine vengono assegnate ai nodi dal primo thread che le usa davvero
+template<typename T>
+struct firstTouchAllocator : std::allocator<T> {
+    template<typename U>
+    struct rebind {
+        using other = firstTouchAllocator<U>;
+    };
+
+    firstTouchAllocator() = default;
+
+    template<typename U>
+    firstTouchAllocator(const firstTouchAllocator<U> &) noexcept {}
+
+    template<typename U>
+    void construct(U *p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+        ::new(static_cast<void *>(p)) U;
+    }
+
+    template<typename U, typename... Args>
+    void construct(U *p, Args &&... args) {
+        ::new(static_cast<void *>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+template<typename T>
+using numaVector = std::vector<T, firstTouchAllocator<T>>;
+
+// Copia src in dst con schedule(static) su omp_get_max_threads() thread: ogni blocco di pagine finisce
+// sul nodo del thread che poi lo elabora nei cicli schedule(static) con lo stesso numero di thread
+template<typename T>
+void firstTouchCopy(std::span<const T> src, numaVector<T> &dst) {
+    static_assert(std::is_trivially_default_constructible_v<T>, "Il tipo non deve inizializzare la memoria");
+    dst.clear();
+    dst.shrink_to_fit();
+    dst.resize(src.size());
+    T *out = dst.data();
+#pragma omp parallel for schedule(static)
+    for (std::size_t j = 0; j < src.size(); j++) {
+        out[j] = src[j];
+    }
+}
+
+// Nodo NUMA di una CPU (0 se il sistema non lo dice)
+inline int cpuNode(int cpu) {
+    std::error_code ec;
+    std::filesystem::path dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    for (const auto &entry: std::filesystem::directory_iterator(dir, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("node", 0) == 0 && name.size() > 4 && std::isdigit(static_cast<unsigned char>(name[4]))) {
+            return std::stoi(name.substr(4));
+        }
+    }
+    return 0;
+}
+
+// Fissa ogni thread OpenMP a una CPU tra quelle concesse al processo. I thread vengono divisi tra i
+// nodi in blocchi consecutivi (con T thread e N nodi i primi T/N sul nodo 0, e così via).
+// Se l'utente ha già scelto una politica con OMP_PROC_BIND non fa nulla.
+// Ritorna la CPU di ogni thread, vuoto se i thread non sono stati fissati
+inline std::vector<int> pinThreads() {
+    std::vector<int> assigned;
+#if defined(__linux__)
+    if (omp_get_proc_bind() != omp_proc_bind_false) {
+        return assigned;
+    }
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return assigned;
+    }
+    std::map<int, std::vector<int>> nodes; // nodo -> CPU concesse
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            nodes[cpuNode(cpu)].push_back(cpu);
+        }
+    }
+    std::vector<std::vector<int>> nodeCpus;
+    for (auto &node: nodes) {
+        nodeCpus.push_back(node.second);
+    }
+
+    int numThreads = omp_get_max_threads();
+    int numNodes = static_cast<int>(nodeCpus.size());
+    assigned.assign(numThreads, -1);
+    for (int t = 0; t < numThreads; t++) {
+        int node = static_cast<int>(static_cast<long long>(t) * numNodes / numThreads);
+        int first = static_cast<int>((static_cast<long long>(node) * numThreads + numNodes - 1) / numNodes);
+        const std::vector<int> &cpus = nodeCpus[node];
+        assigned[t] = cpus[(t - first) % cpus.size()];
+    }
+
+    bool ok = true;
+#pragma omp parallel num_threads(numThreads) reduction(&&:ok)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(assigned[omp_get_thread_num()], &set);
+        ok = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+    if (!ok) {
+        assigned.clear();
+    }
+#endif
+    return assigned;
+}
+
+#endif // KMEANS_NUMA_PLACEMENT_H
@@ -0,0 +1,189 @@
+//
+// Contatori hardware della CPU (perf_event_open di Linux) per capire se un backend è limitato dalla
+// memoria o dal calcolo: cicli, istruzioni, miss dell'ultimo livello di cache e branch mispredetti.
+// Ogni thread OpenMP apre il proprio gruppo di contatori, che conta solo quel thread; i gruppi restano
+// aperti e vengono attivati e fermati dal thread principale attorno alla parte da misurare.
+// Se il sistema non concede i contatori (perf_event_paranoid, container, macchine virtuali, sistemi
+// diversi da Linux) open ritorna false e il resto del programma continua senza misure.
+//
+
+#ifndef KMEANS_PERF_COUNTERS_H
+#define KMEANS_PERF_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Valori sommati su tutti i thread, già corretti per il multiplexing dei contatori
+struct perfTotals {
+    double cycles = 0;
+    double instructions = 0;
+    double cacheMisses = 0;
+    double branchMisses = 0;
+};
+
+class perfCounterSet {
+
+private:
+    static const int numEvents = 4;
+    std::vector<int> leaders;   // un gruppo per thread, -1 se non aperto
+    std::vector<int> fds;       // numEvents descrittori per thread
+    std::string error;
+
+#if defined(__linux__)
+    static int openEvent(std::uint64_t config, int groupFd) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = groupFd < 0 ? 1 : 0; // il gruppo viene attivato dal leader
+        attr.exclude_kernel = 1;             // consentito anche con perf_event_paranoid = 2
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // pid = 0, cpu = -1: il thread chiamante, su qualunque CPU
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+    }
+
+    // Apre il gruppo del thread chiamante nella posizione t
+    bool openThread(int t) {
+        static const std::uint64_t configs[numEvents] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                         PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        int leader = -1;
+        for (int e = 0; e < numEvents; e++) {
+            int fd = openEvent(configs[e], leader);
+            if (fd < 0) {
+                return false;
+            }
+            fds[t * numEvents + e] = fd;
+            if (e == 0) {
+                leader = fd;
+            }
+        }
+        leaders[t] = leader;
+        return true;
+    }
+
+    void groupIoctl(unsigned long request) {
+        for (int fd: leaders) {
+            if (fd >= 0) {
+                ioctl(fd, request, PERF_IOC_FLAG_GROUP);
+            }
+        }
+    }
+#endif
+
+public:
+
+    perfCounterSet() = default;
+    perfCounterSet(const perfCounterSet &) = delete;
+    perfCounterSet &operator=(const perfCounterSet &) = delete;
+
+    ~perfCounterSet() {
+        close();
+    }
+
+    // Apre i contatori su ognuno dei numThreads thread OpenMP. Le regioni parallele successive con lo
+    // stesso numero di thread riusano gli stessi thread, quindi i contatori seguono il lavoro di k-means.
+    // Ritorna false (e lascia il motivo in lastError) se anche un solo gruppo non può essere aperto
+    bool open(int numThreads) {
+        close();
+#if defined(__linux__)
+        leaders.assign(numThreads, -1);
+        fds.assign(numThreads * numEvents, -1);
+        bool ok = true;
+        int failure = 0;
+#pragma omp parallel num_threads(numThreads) reduction(&&:ok)
+        {
+            int t = 0;
+#ifdef _OPENMP
+            t = omp_get_thread_num();
+#endif
+            if (!openThread(t)) {
+                ok = false;
+#pragma omp critical
+                failure = errno;
+            }
+        }
+        if (!ok) {
+            error = std::string("perf_event_open: ") + std::strerror(failure);
+            close();
+            return false;
+        }
+        return true;
+#else
+        (void) numThreads;
+        error = "contatori hardware disponibili solo su Linux";
+        return false;
+#endif
+    }
+
+    bool isOpen() const {
+        return !leaders.empty();
+    }
+
+    const std::string &lastError() const {
+        return error;
+    }
+
+    // Azzera e attiva tutti i gruppi
+    void start() {
+#if defined(__linux__)
+        groupIoctl(PERF_EVENT_IOC_RESET);
+        groupIoctl(PERF_EVENT_IOC_ENABLE);
+#endif
+    }
+
+    void stop() {
+#if defined(__linux__)
+        groupIoctl(PERF_EVENT_IOC_DISABLE);
+#endif
+    }
+
+    // Somma dei contatori dei thread. Se il kernel ha dovuto alternare i contatori (multiplexing)
+    // i valori vengono scalati con il rapporto tra tempo di attivazione e tempo di conteggio
+    perfTotals read() const {
+        perfTotals totals;
+#if defined(__linux__)
+        for (int fd: leaders) {
+            // nr, time_enabled, time_running, poi un valore per evento
+            std::uint64_t values[3 + numEvents] = {};
+            if (fd < 0 || ::read(fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))) {
+                continue;
+            }
+            double scale = values[2] > 0 ? static_cast<double>(values[1]) / values[2] : 0;
+            totals.cycles += values[3] * scale;
+            totals.instructions += values[4] * scale;
+            totals.cacheMisses += values[5] * scale;
+            totals.branchMisses += values[6] * scale;
+        }
+#endif
+        return totals;
+    }
+
+    void close() {
+#if defined(__linux__)
+        for (int fd: fds) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+#endif
+        leaders.clear();
+        fds.clear();
+    }
+};
+
+#endif // KMEANS_PERF_COUNTERS_H
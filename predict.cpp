@@ -0,0 +1,232 @@
+//
+// Inferenza, senza grafica: carica il modello scritto al termine di k-means e assegna ogni punto di un
+// nuovo dataset al centroide più vicino. I punti arrivano a lotti: dal dataset binario mappato in memoria,
+// dal file di testo o da stdin ("-"), quindi la memoria usata non dipende dalla dimensione dell'input.
+// Le etichette vengono scritte come int32 in binario, una per punto nell'ordine di ingresso. Nel testo ogni
+// riga dà un'etichetta: le righe che non contengono D coordinate ricevono -1 e vengono contate.
+//
+// Uso: predict [modello] [dataset | -] [etichette]
+//
+
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include "dataset_binary.h"
+#include "dataset_parser.h"
+#include "model.h"
+#include "predict.h"
+
+// Punti per lotto: le coordinate del lotto e le etichette restano nell'ordine delle decine di MB
+const std::size_t predictBatchSize = 1 << 20;
+// Punti per blocco di lavoro di un thread
+const std::size_t predictChunkSize = 4096;
+// Byte di testo letti per volta da stdin o da file
+const std::size_t predictTextBytes = 16 << 20;
+
+class predictor {
+
+private:
+    const kmeansModel &model;
+    std::vector<double> x_centroids, y_centroids;
+    predictKernel kernel;
+    std::ofstream &outFile;
+    std::vector<int> labels;
+
+public:
+    std::size_t points = 0;
+    std::size_t invalid = 0;
+    double kernelSeconds = 0;
+
+    predictor(const kmeansModel &model, std::ofstream &outFile) : model(model), outFile(outFile) {
+        x_centroids = model.column(0);
+        y_centroids = model.dimension > 1 ? model.column(1) : std::vector<double>();
+        const char *name = "generico";
+        if (model.dimension == 2) {
+            kernel = selectPredictKernel(&name);
+        }
+        std::cout << "[Predict] Kernel: " << name << ", thread: " << omp_get_max_threads() << std::endl;
+    }
+
+    // Assegna un lotto di count punti (columns[d] è la coordinata d) e scrive le etichette.
+    // Se valid non è nullptr i punti con valid[j] == 0 ricevono l'etichetta -1
+    void run(const std::vector<const double *> &columns, std::size_t count,
+             const std::vector<char> *valid = nullptr) {
+        labels.resize(count);
+        double start = omp_get_wtime();
+        std::ptrdiff_t numChunks = (count + predictChunkSize - 1) / predictChunkSize;
+#pragma omp parallel for schedule(static)
+        for (std::ptrdiff_t c = 0; c < numChunks; c++) {
+            std::size_t begin = c * predictChunkSize;
+            std::size_t n = std::min(predictChunkSize, count - begin);
+            if (model.dimension == 2) {
+                kernel(columns[0] + begin, columns[1] + begin, labels.data() + begin, n, x_centroids.data(),
+                       y_centroids.data(), model.numCluster);
+            } else {
+                std::vector<const double *> chunk(columns);
+                for (auto &column: chunk) {
+                    column += begin;
+                }
+                predictGeneric(chunk, labels.data() + begin, n, model.centroids, model.numCluster);
+            }
+        }
+        kernelSeconds += omp_get_wtime() - start;
+        if (valid) {
+            for (std::size_t j = 0; j < count; j++) {
+                if (!(*valid)[j]) {
+                    labels[j] = -1;
+                    invalid++;
+                }
+            }
+        }
+        points += count;
+        outFile.write(reinterpret_cast<const char *>(labels.data()),
+                      static_cast<std::streamsize>(count * sizeof(int)));
+    }
+};
+
+// Dataset binario mappato: le colonne double vengono usate direttamente, quelle float convertite per lotto
+bool predictBinary(const mappedDataset &dataset, predictor &p, int dim) {
+    if (static_cast<int>(dataset.dimension()) != dim) {
+        std::cerr << "[Predict] Il dataset ha " << dataset.dimension() << " dimensioni, il modello " << dim
+                  << std::endl;
+        return false;
+    }
+    std::vector<std::vector<double>> converted(dim);
+    std::vector<const double *> columns(dim);
+    for (std::size_t begin = 0; begin < dataset.size(); begin += predictBatchSize) {
+        std::size_t count = std::min(predictBatchSize, dataset.size() - begin);
+        for (int d = 0; d < dim; d++) {
+            if (dataset.type() == datasetFloat64) {
+                columns[d] = dataset.column(d).data() + begin;
+            } else {
+                std::span<const float> values = dataset.column<float>(d).subspan(begin, count);
+                converted[d].assign(values.begin(), values.end());
+                columns[d] = converted[d].data();
+            }
+        }
+        p.run(columns, count);
+    }
+    return true;
+}
+
+// Testo da uno stream, letto a blocchi di byte tagliati all'ultima riga completa. Le righe di un blocco
+// vengono convertite in parallelo; una riga senza D coordinate resta nel lotto come punto non valido,
+// così le etichette restano allineate alle righe di ingresso
+bool predictText(std::istream &in, predictor &p, int dim) {
+    std::vector<char> buffer;
+    std::vector<std::size_t> lineStarts;
+    std::vector<std::vector<double>> values(dim);
+    std::vector<const double *> columns(dim);
+    std::vector<char> valid;
+    std::size_t pending = 0; // byte di una riga incompleta rimasti dal blocco precedente
+    while (in) {
+        buffer.resize(pending + predictTextBytes);
+        in.read(buffer.data() + pending, static_cast<std::streamsize>(predictTextBytes));
+        std::size_t size = pending + static_cast<std::size_t>(in.gcount());
+        std::size_t complete = size;
+        if (in) {
+            while (complete > 0 && buffer[complete - 1] != '\n') {
+                complete--;
+            }
+            if (complete == 0) {
+                complete = size; // riga più lunga del blocco: viene letta com'è
+            }
+        }
+
+        // Inizio di ogni riga; l'ultima riga del file può non avere '\n'
+        lineStarts.clear();
+        for (std::size_t pos = 0; pos < complete;) {
+            lineStarts.push_back(pos);
+            const void *newline = std::memchr(buffer.data() + pos, '\n', complete - pos);
+            pos = newline ? static_cast<const char *>(newline) - buffer.data() + 1 : complete;
+        }
+        std::size_t count = lineStarts.size();
+        lineStarts.push_back(complete);
+
+        if (count > 0) {
+            for (int d = 0; d < dim; d++) {
+                values[d].resize(count);
+                columns[d] = values[d].data();
+            }
+            valid.assign(count, 0);
+            const char *data = buffer.data();
+#pragma omp parallel for schedule(static)
+            for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(count); i++) {
+                const char *q = data + lineStarts[i];
+                const char *lineEnd = data + lineStarts[i + 1];
+                for (int d = 0; d < dim && q; d++) {
+                    double value = 0;
+                    q = parseNumber(q, lineEnd, value);
+                    values[d][i] = value;
+                }
+                valid[i] = q != nullptr;
+            }
+            p.run(columns, count, &valid);
+        }
+        pending = size - complete;
+        std::copy(buffer.begin() + complete, buffer.begin() + size, buffer.begin());
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    std::string modelPath = argc > 1 ? argv[1] : "../dataset/model.kmm";
+    std::string path = argc > 2 ? argv[2] : "../dataset/dataset.txt";
+    std::string labelsPath = argc > 3 ? argv[3] : "../dataset/labels.bin";
+
+    std::cout << "[Predict] Assegnazione dei punti ai centroidi del modello\n" << std::endl;
+
+    kmeansModel model;
+    if (!readModel(modelPath, model)) {
+        std::cerr << "[Predict] Errore nella lettura del modello " << modelPath << " (file non valido, troncato o con più di "
+                  << maxParsedDimension << " dimensioni)" << std::endl;
+        return 1;
+    }
+    std::cout << "[Predict] Modello: " << model.numCluster << " cluster in " << model.dimension
+              << " dimensioni, addestrato da " << model.source << " su " << model.trainPoints << " punti ("
+              << model.iterations << " iterazioni)" << std::endl;
+
+    std::ofstream outFile(labelsPath, std::ios::binary | std::ios::trunc);
+    if (!outFile) {
+        std::cerr << "[Predict] Errore nell'apertura di " << labelsPath << std::endl;
+        return 1;
+    }
+
+    predictor p(model, outFile);
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    bool ok;
+    mappedDataset binaryDataset;
+    if (path == "-") {
+        std::ios::sync_with_stdio(false);
+        ok = predictText(std::cin, p, model.dimension);
+    } else if (binaryDataset.open(path)) {
+        ok = predictBinary(binaryDataset, p, model.dimension);
+    } else {
+        std::ifstream inFile(path, std::ios::binary);
+        if (!inFile) {
+            std::cerr << "[Predict] Errore nell'apertura del file" << std::endl;
+            return 1;
+        }
+        ok = predictText(inFile, p, model.dimension);
+    }
+    outFile.close();
+    std::chrono::duration<double> elapsed_seconds = std::chrono::steady_clock::now() - start_time;
+    if (!ok || !outFile) {
+        return 1;
+    }
+
+    if (p.invalid > 0) {
+        std::cerr << "[Predict] Righe non valide (etichetta -1): " << p.invalid << std::endl;
+    }
+    std::cout << "[Predict] Punti assegnati: " << p.points << " in " << elapsed_seconds.count() << " secondi ("
+              << p.points / elapsed_seconds.count() << " punti/s, lettura compresa)" << std::endl;
+    std::cout << "[Predict] Solo assegnazione: " << p.kernelSeconds << " secondi ("
+              << (p.kernelSeconds > 0 ? p.points / p.kernelSeconds : 0) << " punti/s)" << std::endl;
+    std::cout << "[Predict] Etichette scritte in " << labelsPath << std::endl;
+    return 0;
+}
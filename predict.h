@@ -0,0 +1,142 @@
+//
+// Assegnazione di nuovi punti ai centroidi di un modello (inferenza): solo l'argmin della distanza,
+// senza somme per cluster, quindi un punto costa K distanze e una scrittura dell'etichetta.
+// Per D = 2 i kernel SIMD seguono quelli di soa_kernel.h (scelta a runtime tra AVX-512, AVX2 e scalare);
+// con altre dimensioni i punti vengono elaborati a blocchi, una coordinata per volta, in cicli che il
+// compilatore vettorizza da solo.
+//
+
+#ifndef KMEANS_PREDICT_H
+#define KMEANS_PREDICT_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "soa_kernel.h"
+
+typedef void (*predictKernel)(const double *x_values, const double *y_values, int *labels, std::size_t count,
+                              const double *x_centroids, const double *y_centroids, int numCluster);
+
+inline void predictScalar(const double *x_values, const double *y_values, int *labels, std::size_t count,
+                          const double *x_centroids, const double *y_centroids, int numCluster) {
+    for (std::size_t j = 0; j < count; j++) {
+        double best = INFINITY;
+        int bestIdx = 0;
+        for (int k = 0; k < numCluster; k++) {
+            double dx = x_centroids[k] - x_values[j];
+            double dy = y_centroids[k] - y_values[j];
+            double d = dx * dx + dy * dy;
+            if (d < best) {
+                best = d;
+                bestIdx = k;
+            }
+        }
+        labels[j] = bestIdx;
+    }
+}
+
+#ifdef KMEANS_X86
+
+KMEANS_TARGET("avx2")
+inline void predictAVX2(const double *x_values, const double *y_values, int *labels, std::size_t count,
+                        const double *x_centroids, const double *y_centroids, int numCluster) {
+    std::size_t j = 0;
+    for (; j + 4 <= count; j += 4) {
+        __m256d px = _mm256_loadu_pd(x_values + j);
+        __m256d py = _mm256_loadu_pd(y_values + j);
+        __m256d best = _mm256_set1_pd(INFINITY);
+        __m256d bestIdx = _mm256_setzero_pd();
+        for (int k = 0; k < numCluster; k++) {
+            __m256d dx = _mm256_sub_pd(_mm256_broadcast_sd(x_centroids + k), px);
+            __m256d dy = _mm256_sub_pd(_mm256_broadcast_sd(y_centroids + k), py);
+            __m256d d = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+            __m256d lt = _mm256_cmp_pd(d, best, _CMP_LT_OQ);
+            best = _mm256_min_pd(d, best);
+            bestIdx = _mm256_blendv_pd(bestIdx, _mm256_set1_pd(k), lt);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(labels + j), _mm256_cvtpd_epi32(bestIdx));
+    }
+    predictScalar(x_values + j, y_values + j, labels + j, count - j, x_centroids, y_centroids, numCluster);
+}
+
+KMEANS_TARGET("avx512f")
+inline void predictAVX512(const double *x_values, const double *y_values, int *labels, std::size_t count,
+                          const double *x_centroids, const double *y_centroids, int numCluster) {
+    std::size_t j = 0;
+    for (; j + 8 <= count; j += 8) {
+        __m512d px = _mm512_loadu_pd(x_values + j);
+        __m512d py = _mm512_loadu_pd(y_values + j);
+        __m512d best = _mm512_set1_pd(INFINITY);
+        __m512d bestIdx = _mm512_setzero_pd();
+        for (int k = 0; k < numCluster; k++) {
+            __m512d dx = _mm512_sub_pd(_mm512_set1_pd(x_centroids[k]), px);
+            __m512d dy = _mm512_sub_pd(_mm512_set1_pd(y_centroids[k]), py);
+            __m512d d = _mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy));
+            __mmask8 lt = _mm512_cmp_pd_mask(d, best, _CMP_LT_OQ);
+            best = _mm512_mask_blend_pd(lt, best, d);
+            bestIdx = _mm512_mask_blend_pd(lt, bestIdx, _mm512_set1_pd(k));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(labels + j), _mm512_cvtpd_epi32(bestIdx));
+    }
+    predictScalar(x_values + j, y_values + j, labels + j, count - j, x_centroids, y_centroids, numCluster);
+}
+
+#endif // KMEANS_X86
+
+// Sceglie il kernel 2D migliore supportato dalla CPU
+inline predictKernel selectPredictKernel(const char **name) {
+#if defined(KMEANS_X86) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        *name = "AVX-512";
+        return predictAVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        *name = "AVX2";
+        return predictAVX2;
+    }
+#elif defined(KMEANS_X86) && defined(_MSC_VER)
+    if (cpuHasFeature(7, 1, 16, 0xE6)) {
+        *name = "AVX-512";
+        return predictAVX512;
+    }
+    if (cpuHasFeature(7, 1, 5, 0x6)) {
+        *name = "AVX2";
+        return predictAVX2;
+    }
+#endif
+    *name = "scalare";
+    return predictScalar;
+}
+
+// Punti per blocco del kernel generico: le distanze del blocco restano in L1
+const std::size_t predictBlockSize = 256;
+
+// Kernel per D qualsiasi: columns[d] è la coordinata d dei punti, centroids è row-major (K x D)
+inline void predictGeneric(const std::vector<const double *> &columns, int *labels, std::size_t count,
+                           const std::vector<double> &centroids, int numCluster) {
+    int dim = static_cast<int>(columns.size());
+    double best[predictBlockSize], dist[predictBlockSize];
+    for (std::size_t begin = 0; begin < count; begin += predictBlockSize) {
+        std::size_t n = std::min(predictBlockSize, count - begin);
+        std::fill_n(best, n, INFINITY);
+        for (int k = 0; k < numCluster; k++) {
+            std::fill_n(dist, n, 0.0);
+            for (int d = 0; d < dim; d++) {
+                const double *values = columns[d] + begin;
+                double c = centroids[static_cast<std::size_t>(k) * dim + d];
+                for (std::size_t j = 0; j < n; j++) {
+                    double diff = values[j] - c;
+                    dist[j] += diff * diff;
+                }
+            }
+            for (std::size_t j = 0; j < n; j++) {
+                labels[begin + j] = dist[j] < best[j] ? k : labels[begin + j];
+                best[j] = std::min(dist[j], best[j]);
+            }
+        }
+    }
+}
+
+#endif // KMEANS_PREDICT_H
@@ -0,0 +1,215 @@
+//
+// Disegno dei risultati con SFML. I punti vengono convertiti una volta sola in un sf::VertexArray
+// (o, se sono più dei pixel della finestra, in una texture di densità) e riusati a ogni frame;
+// la finestra viene ridisegnata solo quando arriva un evento.
+//
+
+#ifndef KMEANS_RENDERER_H
+#define KMEANS_RENDERER_H
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+#include <SFML/Graphics.hpp>
+#include "kmeans.h"
+
+// Colore del cluster id: i primi 10 sono quelli usati finora, poi tinte distanziate dal rapporto aureo
+inline sf::Color clusterColor(int id) {
+    static const sf::Color base[] = {
+            sf::Color::Red, sf::Color::Blue, sf::Color::Green, sf::Color::Yellow, sf::Color::Magenta,
+            sf::Color::Cyan,
+            sf::Color(255, 182, 193), // rosa
+            sf::Color(165, 42, 42),   // marrone
+            sf::Color(128, 128, 128), // grigio
+            sf::Color(128, 0, 128)    // viola
+    };
+    if (id < 0) {
+        return sf::Color(200, 200, 200); // punto non assegnato
+    }
+    if (id < 10) {
+        return base[id];
+    }
+    // HSV con saturazione e valore fissi, tinta in [0, 6)
+    double hue = std::fmod(id * 0.618033988749895, 1.0) * 6;
+    double s = 0.75, v = 0.9;
+    double c = v * s;
+    double x = c * (1 - std::fabs(std::fmod(hue, 2.0) - 1));
+    double r = 0, g = 0, b = 0;
+    switch (static_cast<int>(hue)) {
+        case 0: r = c; g = x; break;
+        case 1: r = x; g = c; break;
+        case 2: g = c; b = x; break;
+        case 3: g = x; b = c; break;
+        case 4: r = x; b = c; break;
+        default: r = c; b = x; break;
+    }
+    double m = v - c;
+    return sf::Color(static_cast<sf::Uint8>((r + m) * 255), static_cast<sf::Uint8>((g + m) * 255),
+                     static_cast<sf::Uint8>((b + m) * 255));
+}
+
+class clusterRenderer {
+
+private:
+    std::string tag;
+    unsigned width;
+    unsigned height;
+    sf::VertexArray points{sf::Points};
+    sf::Image densityImage;
+    sf::Texture densityTexture;
+    bool useDensity = false;
+    std::vector<sf::CircleShape> centroids;
+    sf::VertexArray axes{sf::Lines, 4};
+    sf::Font font;
+    bool fontLoaded = false;
+
+    // Pixel della finestra corrispondente al punto (x, y), con l'origine al centro
+    sf::Vector2f toScreen(double x, double y) const {
+        return {static_cast<float>(x + width / 2.0), static_cast<float>(height / 2.0 - y)};
+    }
+
+    // Con più punti che pixel ogni pixel prende la media dei colori dei propri punti
+    template<typename PointAt>
+    void buildDensity(std::size_t numPoints, PointAt pointAt) {
+        std::vector<std::uint32_t> sums(static_cast<std::size_t>(width) * height * 4, 0);
+        for (std::size_t j = 0; j < numPoints; j++) {
+            auto [x, y, id] = pointAt(j);
+            sf::Vector2f p = toScreen(x, y);
+            if (p.x < 0 || p.y < 0 || p.x >= width || p.y >= height) {
+                continue;
+            }
+            std::uint32_t *pixel = &sums[(static_cast<std::size_t>(p.y) * width + static_cast<std::size_t>(p.x)) * 4];
+            sf::Color color = clusterColor(id);
+            pixel[0] += color.r;
+            pixel[1] += color.g;
+            pixel[2] += color.b;
+            pixel[3]++;
+        }
+        densityImage.create(width, height, sf::Color::Transparent);
+        for (unsigned py = 0; py < height; py++) {
+            for (unsigned px = 0; px < width; px++) {
+                const std::uint32_t *pixel = &sums[(static_cast<std::size_t>(py) * width + px) * 4];
+                if (pixel[3] > 0) {
+                    densityImage.setPixel(px, py, sf::Color(pixel[0] / pixel[3], pixel[1] / pixel[3],
+                                                            pixel[2] / pixel[3]));
+                }
+            }
+        }
+        densityTexture.loadFromImage(densityImage);
+    }
+
+    template<typename PointAt>
+    void buildPoints(std::size_t numPoints, PointAt pointAt) {
+        useDensity = numPoints > static_cast<std::size_t>(width) * height;
+        if (useDensity) {
+            points.clear();
+            buildDensity(numPoints, pointAt);
+            return;
+        }
+        points.resize(numPoints);
+        for (std::size_t j = 0; j < numPoints; j++) {
+            auto [x, y, id] = pointAt(j);
+            points[j] = sf::Vertex(toScreen(x, y), clusterColor(id));
+        }
+    }
+
+    void draw(sf::RenderWindow &window) {
+        window.clear(sf::Color::White);
+        window.draw(axes);
+        if (fontLoaded) {
+            // Etichette degli assi
+            sf::Text xAxisLabel("x", font, 16);
+            xAxisLabel.setFillColor(sf::Color::Black);
+            xAxisLabel.setPosition(width - 20, height / 2 + 10);
+            sf::Text yAxisLabel("y", font, 16);
+            yAxisLabel.setFillColor(sf::Color::Black);
+            yAxisLabel.setPosition(width / 2 + 10, 10);
+            window.draw(xAxisLabel);
+            window.draw(yAxisLabel);
+        }
+        if (useDensity) {
+            window.draw(sf::Sprite(densityTexture));
+        } else {
+            window.draw(points);
+        }
+        for (const auto &shape: centroids) {
+            window.draw(shape);
+        }
+        window.display();
+    }
+
+public:
+
+    // tag: prefisso dei messaggi ("[Seq]", "[Par]", ...); size: dimensione della finestra
+    clusterRenderer(const std::string &logTag, sf::Vector2u size) : tag(logTag), width(size.x), height(size.y) {
+        axes[0] = sf::Vertex(sf::Vector2f(0, height / 2.0f), sf::Color::Black);
+        axes[1] = sf::Vertex(sf::Vector2f(width, height / 2.0f), sf::Color::Black);
+        axes[2] = sf::Vertex(sf::Vector2f(width / 2.0f, 0), sf::Color::Black);
+        axes[3] = sf::Vertex(sf::Vector2f(width / 2.0f, height), sf::Color::Black);
+
+        // Il font viene caricato una volta sola; senza font mancano solo le etichette degli assi
+        fontLoaded = font.loadFromFile("../font/arial.ttf");
+        if (!fontLoaded) {
+            std::cerr << tag << " Impossibile caricare il font Arial." << std::endl;
+        }
+    }
+
+    // Punti AoS, colorati con clusterID
+    void setPoints(std::span<const point> data) {
+        buildPoints(data.size(), [&](std::size_t j) {
+            return std::make_tuple(data[j].x, data[j].y, data[j].clusterID);
+        });
+    }
+
+    // Punti SoA, colorati con points_id
+    template<typename T>
+    void setPoints(std::span<const T> x_values, std::span<const T> y_values, const std::vector<int> &points_id) {
+        buildPoints(points_id.size(), [&](std::size_t j) {
+            return std::make_tuple(static_cast<double>(x_values[j]), static_cast<double>(y_values[j]), points_id[j]);
+        });
+    }
+
+    void setCentroids(const std::vector<double> &x_centroids, const std::vector<double> &y_centroids) {
+        centroids.clear();
+        for (std::size_t c = 0; c < x_centroids.size(); c++) {
+            sf::CircleShape shape(3);
+            shape.setFillColor(sf::Color::Black);
+            shape.setPosition(toScreen(x_centroids[c], y_centroids[c]));
+            centroids.push_back(shape);
+        }
+    }
+
+    void setCentroids(const std::vector<point> &data) {
+        std::vector<double> x_centroids, y_centroids;
+        for (const auto &c: data) {
+            x_centroids.push_back(c.x);
+            y_centroids.push_back(c.y);
+        }
+        setCentroids(x_centroids, y_centroids);
+    }
+
+    // Ciclo degli eventi: la finestra resta ferma in waitEvent finché non succede qualcosa,
+    // e viene ridisegnata solo se il contenuto può essere stato perso (ridimensionamento, focus)
+    void run(sf::RenderWindow &window) {
+        draw(window);
+        sf::Event event{};
+        while (window.isOpen() && window.waitEvent(event)) {
+            switch (event.type) {
+                case sf::Event::Closed:
+                    window.close();
+                    break;
+                case sf::Event::Resized:
+                case sf::Event::GainedFocus:
+                    draw(window);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+};
+
+#endif // KMEANS_RENDERER_H
@@ -0,0 +1,226 @@
+//
+// Più esecuzioni di k-means (restart) con centroidi iniziali diversi sullo stesso dataset in memoria,
+// tenendo quella con l'inerzia minore: una sola esecuzione può fermarsi in un minimo locale cattivo.
+// I restart avanzano insieme, un'iterazione per volta: i punti vengono letti a blocchi abbastanza piccoli
+// da restare in cache e ogni blocco viene assegnato ai centroidi di tutti i restart ancora attivi prima
+// di passare al successivo, quindi una passata sulla memoria serve a tutti i restart.
+// L'assegnazione usa i kernel SIMD di soa_kernel.h, i blocchi sono divisi tra i thread come in
+// kmeanSoAParallel.
+//
+
+#ifndef KMEANS_RESTARTS_H
+#define KMEANS_RESTARTS_H
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <span>
+#include <vector>
+#include <omp.h>
+#include "kmeans.h"
+#include "seeding.h"
+#include "soa_kmeans.h"
+
+// Punti per blocco: x, y e le etichette di qualche esecuzione stanno nella cache L2
+const std::size_t restartBlockSize = 2048;
+
+struct restartResult {
+    unsigned long long seed;        // seme di k-means++ per i centroidi iniziali
+    std::vector<double> x_centroids;
+    std::vector<double> y_centroids;
+    std::vector<int> points_id;
+    int iterations = 0;
+    double seedingSeconds = 0;
+    double seconds = 0;             // dall'inizio delle iterazioni alla convergenza di questo restart
+    double inertia = 0;             // somma delle distanze al quadrato dai centroidi finali
+};
+
+// Somma delle distanze al quadrato di ogni punto dal centroide del proprio cluster
+inline double clusterInertia(std::span<const double> x_values, std::span<const double> y_values,
+                             const std::vector<int> &points_id, const std::vector<double> &x_centroids,
+                             const std::vector<double> &y_centroids) {
+    double inertia = 0;
+#pragma omp parallel for schedule(static) reduction(+:inertia)
+    for (std::size_t j = 0; j < x_values.size(); j++) {
+        double dx = x_values[j] - x_centroids[points_id[j]];
+        double dy = y_values[j] - y_centroids[points_id[j]];
+        inertia += dx * dx + dy * dy;
+    }
+    return inertia;
+}
+
+// Esegue insieme le esecuzioni di runs, ognuna dai propri centroidi iniziali (il numero di cluster
+// può essere diverso tra un'esecuzione e l'altra). Al termine ogni esecuzione ha centroidi, etichette,
+// iterazioni, tempo e inerzia. tag è il prefisso dei messaggi
+inline void kmeanLockstep(std::span<const double> x_values, std::span<const double> y_values,
+                          std::vector<restartResult> &runs, int maxIter, const char *tag) {
+    std::size_t numPoints = x_values.size();
+    int numRuns = static_cast<int>(runs.size());
+    if (numRuns == 0 || numPoints == 0) {
+        return;
+    }
+
+    // Accumulatori per thread e per esecuzione, con la stessa spaziatura di kmeanSoAParallel
+    std::vector<std::size_t> offsetSums(numRuns + 1, 0), offsetCount(numRuns + 1, 0);
+    std::size_t strideScratch = 0;
+    for (int r = 0; r < numRuns; r++) {
+        int numCluster = static_cast<int>(runs[r].x_centroids.size());
+        runs[r].points_id.assign(numPoints, -1);
+        offsetSums[r + 1] = offsetSums[r] + (numCluster + 7) / 8 * 8 + 8;
+        offsetCount[r + 1] = offsetCount[r] + (numCluster + 15) / 16 * 16 + 16;
+        strideScratch = std::max(strideScratch, (assignScratchSize(numCluster) + 7) / 8 * 8 + 8);
+    }
+    int numThreads = omp_get_max_threads();
+    std::size_t threadSums = offsetSums[numRuns];
+    std::size_t threadCounts = offsetCount[numRuns];
+    std::vector<double> localX(numThreads * threadSums);
+    std::vector<double> localY(numThreads * threadSums);
+    std::vector<int> localCount(numThreads * threadCounts);
+    // Il kernel lascia azzerato il buffer delle lane: uno per thread basta per tutte le esecuzioni
+    std::vector<double> laneScratch(numThreads * strideScratch, 0.0);
+    std::vector<int> localChanged(numThreads * numRuns * 16);
+
+    // Confini dei blocchi di ogni esecuzione: le etichette di ogni esecuzione hanno il proprio allineamento,
+    // quindi i confini che non dividono le linee di cache di points_id cambiano di qualche punto tra
+    // un'esecuzione e l'altra. Ogni thread scorre l'unione dei propri intervalli, spanBegin-spanEnd
+    std::vector<std::vector<std::size_t>> bounds(numRuns);
+    std::vector<std::size_t> spanBegin(numThreads, numPoints), spanEnd(numThreads, 0);
+    for (int r = 0; r < numRuns; r++) {
+        bounds[r] = chunkBounds(runs[r].points_id, numThreads);
+        for (int c = 0; c < numThreads; c++) {
+            spanBegin[c] = std::min(spanBegin[c], bounds[r][c]);
+            spanEnd[c] = std::max(spanEnd[c], bounds[r][c + 1]);
+        }
+    }
+
+    const char *kernelName;
+    assignKernel assign = selectAssignKernel(&kernelName);
+    std::cout << tag << " Kernel di assegnazione: " << kernelName << std::endl;
+
+    std::vector<int> active(numRuns);
+    for (int r = 0; r < numRuns; r++) {
+        active[r] = r;
+    }
+    double start = omp_get_wtime();
+    int i = 0;
+
+    while (!active.empty()) {
+        if (i % 10 == 0)
+            std::cout << tag << " Numero iterazioni k-means: " << i << ", esecuzioni attive: " << active.size()
+                      << std::endl;
+        i++;
+
+#pragma omp parallel num_threads(numThreads)
+        {
+            int t = omp_get_thread_num();
+            for (int r: active) {
+                int numCluster = static_cast<int>(runs[r].x_centroids.size());
+                std::fill_n(&localX[t * threadSums + offsetSums[r]], numCluster, 0.0);
+                std::fill_n(&localY[t * threadSums + offsetSums[r]], numCluster, 0.0);
+                std::fill_n(&localCount[t * threadCounts + offsetCount[r]], numCluster, 0);
+                localChanged[(t * numRuns + r) * 16] = 0;
+            }
+
+            // Ogni blocco di punti viene assegnato a tutte le esecuzioni attive finché è in cache
+            for (int c = t; c < numThreads; c += omp_get_num_threads()) {
+                for (std::size_t begin = spanBegin[c]; begin < spanEnd[c]; begin += restartBlockSize) {
+                    std::size_t end = std::min(begin + restartBlockSize, spanEnd[c]);
+                    for (int r: active) {
+                        restartResult &run = runs[r];
+                        std::size_t first = std::max(begin, bounds[r][c]);
+                        std::size_t last = std::min(end, bounds[r][c + 1]);
+                        if (first >= last) {
+                            continue;
+                        }
+                        bool changed = assign(x_values.data(), y_values.data(), run.points_id.data(), first, last,
+                                              run.x_centroids.data(), run.y_centroids.data(),
+                                              static_cast<int>(run.x_centroids.size()),
+                                              &localX[t * threadSums + offsetSums[r]],
+                                              &localY[t * threadSums + offsetSums[r]],
+                                              &localCount[t * threadCounts + offsetCount[r]],
+                                              &laneScratch[t * strideScratch]);
+                        localChanged[(t * numRuns + r) * 16] |= changed;
+                    }
+                }
+            }
+        }
+
+        // Somma degli accumulatori dei thread e aggiornamento dei centroidi di ogni esecuzione
+        std::vector<int> stillActive;
+        for (int r: active) {
+            restartResult &run = runs[r];
+            int numCluster = static_cast<int>(run.x_centroids.size());
+            bool centerUpdated = false;
+            for (int t = 0; t < numThreads; t++) {
+                centerUpdated = centerUpdated || localChanged[(t * numRuns + r) * 16];
+            }
+            for (int w = 0; w < numCluster; ++w) {
+                double totalX = 0, totalY = 0;
+                int countPoints = 0;
+                for (int t = 0; t < numThreads; t++) {
+                    totalX += localX[t * threadSums + offsetSums[r] + w];
+                    totalY += localY[t * threadSums + offsetSums[r] + w];
+                    countPoints += localCount[t * threadCounts + offsetCount[r] + w];
+                }
+                if (countPoints > 0) {
+                    run.x_centroids[w] = totalX / countPoints;
+                    run.y_centroids[w] = totalY / countPoints;
+                }
+            }
+            run.iterations = i;
+            if (centerUpdated && i <= maxIter) {
+                stillActive.push_back(r);
+            } else {
+                run.seconds = omp_get_wtime() - start;
+            }
+        }
+        active = stillActive;
+    }
+
+    for (restartResult &run: runs) {
+        run.inertia = clusterInertia(x_values, y_values, run.points_id, run.x_centroids, run.y_centroids);
+    }
+}
+
+// numRestarts esecuzioni con semi seed, seed + 1, ...; best riceve l'indice del restart con l'inerzia minore
+inline std::vector<restartResult> kmeanRestarts(std::span<const double> x_values, std::span<const double> y_values,
+                                                int numCluster, int numRestarts, int maxIter,
+                                                unsigned long long seed, int *best = nullptr) {
+    std::vector<restartResult> results(std::max(numRestarts, 0));
+    std::size_t numPoints = x_values.size();
+    if (results.empty() || numPoints == 0) {
+        return results;
+    }
+
+    // Centroidi iniziali: k-means++ con un seme diverso per restart
+    std::vector<point> points(numPoints);
+#pragma omp parallel for schedule(static)
+    for (std::size_t j = 0; j < numPoints; j++) {
+        points[j] = point{x_values[j], y_values[j], -1};
+    }
+    for (int r = 0; r < numRestarts; r++) {
+        double seedStart = omp_get_wtime();
+        results[r].seed = seed + r;
+        for (const auto &c: seedKmeansPlusPlus(points, numCluster, results[r].seed)) {
+            results[r].x_centroids.push_back(c.x);
+            results[r].y_centroids.push_back(c.y);
+        }
+        results[r].seedingSeconds = omp_get_wtime() - seedStart;
+    }
+    points = std::vector<point>();
+
+    kmeanLockstep(x_values, y_values, results, maxIter, "[Restart]");
+
+    int bestRun = 0;
+    for (int r = 0; r < numRestarts; r++) {
+        if (results[r].inertia < results[bestRun].inertia) {
+            bestRun = r;
+        }
+    }
+    if (best) {
+        *best = bestRun;
+    }
+    return results;
+}
+
+#endif // KMEANS_RESTARTS_H
@@ -0,0 +1,290 @@
+//
+// Scelta dei centroidi iniziali a partire dai punti: k-means++ (Arthur e Vassilvitskii, 2007) e la
+// variante parallela con sovracampionamento k-means|| (Bahmani et al., 2012). Centroidi iniziali
+// vicini ai cluster reali riducono il numero di iterazioni di Lloyd necessarie a convergere.
+//
+
+#ifndef KMEANS_SEEDING_H
+#define KMEANS_SEEDING_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "kmeans.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+enum class seedingMethod {
+    random,         // posizioni casuali nel rettangolo del dataset, distanti almeno centerDist
+    kmeansPlusPlus, // k-means++: K passate sui punti
+    kmeansParallel  // k-means||: pochi round che campionano molti candidati, poi k-means++ pesato sui candidati
+};
+
+// I punti sono divisi in un numero fisso di blocchi, indipendente dal numero di thread:
+// somme e campionamenti avvengono sempre nello stesso ordine e il risultato dipende solo dal seme
+const int seedingChunks = 256;
+
+inline std::size_t seedingChunkBegin(std::size_t n, int c) {
+    return n * c / seedingChunks;
+}
+
+inline double squaredDistance(const point &a, const point &b) {
+    return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y);
+}
+
+// Aggiorna la distanza al quadrato di ogni punto dal centroide più vicino tra quelli scelti finora
+inline void updateNearest(const std::vector<point> &points, const std::vector<point> &centers, std::size_t first,
+                          std::vector<double> &d2, std::vector<int> &nearest) {
+#pragma omp parallel for schedule(static)
+    for (std::size_t i = 0; i < points.size(); i++) {
+        for (std::size_t c = first; c < centers.size(); c++) {
+            double dist = squaredDistance(points[i], centers[c]);
+            if (dist < d2[i]) {
+                d2[i] = dist;
+                nearest[i] = c;
+            }
+        }
+    }
+}
+
+// Somme di d2 per blocco, ritorna il totale
+inline double chunkSums(const std::vector<double> &d2, std::vector<double> &sums) {
+    std::size_t n = d2.size();
+    sums.assign(seedingChunks, 0);
+#pragma omp parallel for schedule(static)
+    for (int c = 0; c < seedingChunks; c++) {
+        double sum = 0;
+        for (std::size_t i = seedingChunkBegin(n, c); i < seedingChunkBegin(n, c + 1); i++) {
+            sum += d2[i];
+        }
+        sums[c] = sum;
+    }
+    double total = 0;
+    for (double sum: sums) {
+        total += sum;
+    }
+    return total;
+}
+
+// Indice del punto in cui cade r lungo la somma cumulativa di d2: prima si trova il blocco, poi il punto
+inline std::size_t sampleByDistance(const std::vector<double> &d2, const std::vector<double> &sums, double r) {
+    std::size_t n = d2.size();
+    int c = 0;
+    while (c < seedingChunks - 1 && r >= sums[c]) {
+        r -= sums[c];
+        c++;
+    }
+    std::size_t last = seedingChunkBegin(n, c);
+    for (std::size_t i = seedingChunkBegin(n, c); i < seedingChunkBegin(n, c + 1); i++) {
+        if (d2[i] > 0) {
+            last = i;
+            if (r < d2[i]) {
+                return i;
+            }
+            r -= d2[i];
+        }
+    }
+    return last; // errori di arrotondamento: l'ultimo punto con peso non nullo del blocco
+}
+
+// Costo totale (somma di d2) se candidate venisse aggiunto ai centroidi
+inline double potentialWith(const std::vector<point> &points, const std::vector<double> &d2, const point &candidate) {
+    std::size_t n = points.size();
+    std::vector<double> sums(seedingChunks, 0);
+#pragma omp parallel for schedule(static)
+    for (int c = 0; c < seedingChunks; c++) {
+        double sum = 0;
+        for (std::size_t i = seedingChunkBegin(n, c); i < seedingChunkBegin(n, c + 1); i++) {
+            sum += std::min(d2[i], squaredDistance(points[i], candidate));
+        }
+        sums[c] = sum;
+    }
+    double total = 0;
+    for (double sum: sums) {
+        total += sum;
+    }
+    return total;
+}
+
+// k-means++: ogni nuovo centroide è un punto scelto con probabilità proporzionale alla distanza al quadrato
+// dal centroide più vicino. Come in scikit-learn si estraggono 2 + log(K) candidati e si tiene quello che
+// riduce di più il costo: evita quasi sempre due centroidi nello stesso cluster. Le passate sono parallele
+inline std::vector<point> seedKmeansPlusPlus(const std::vector<point> &points, int numClusters,
+                                             unsigned long long seed) {
+    std::vector<point> centers;
+    if (points.empty()) {
+        return centers;
+    }
+    int trials = 2 + static_cast<int>(std::log(numClusters));
+    std::mt19937_64 gen(seed);
+    std::vector<double> d2(points.size(), INFINITY);
+    std::vector<int> nearest(points.size(), 0);
+    std::vector<double> sums;
+
+    centers.push_back(points[std::uniform_int_distribution<std::size_t>(0, points.size() - 1)(gen)]);
+    while (static_cast<int>(centers.size()) < numClusters) {
+        updateNearest(points, centers, centers.size() - 1, d2, nearest);
+        double total = chunkSums(d2, sums);
+        if (total <= 0) {
+            // Tutti i punti coincidono con un centroide: si ripete un punto qualsiasi
+            centers.push_back(points[std::uniform_int_distribution<std::size_t>(0, points.size() - 1)(gen)]);
+            continue;
+        }
+        std::size_t best = 0;
+        double bestPotential = INFINITY;
+        for (int t = 0; t < trials; t++) {
+            std::size_t candidate = sampleByDistance(d2, sums, std::uniform_real_distribution<double>(0, total)(gen));
+            double potential = potentialWith(points, d2, points[candidate]);
+            if (potential < bestPotential) {
+                bestPotential = potential;
+                best = candidate;
+            }
+        }
+        centers.push_back(points[best]);
+    }
+    return centers;
+}
+
+// k-means|| ridotto ai K centroidi finali: k-means++ pesato sui candidati (con la stessa scelta
+// tra 2 + log(K) estrazioni), seguito da qualche iterazione di Lloyd pesata.
+// I candidati sono poche centinaia, quindi basta un solo thread
+inline std::vector<point> reduceCandidates(const std::vector<point> &candidates, const std::vector<long long> &weights,
+                                           int numClusters, std::mt19937_64 &gen) {
+    int numCandidates = candidates.size();
+    int trials = 2 + static_cast<int>(std::log(numClusters));
+    std::vector<point> centers;
+    std::vector<double> d2(numCandidates, INFINITY);
+    std::vector<double> score(numCandidates);
+
+    std::discrete_distribution<int> byWeight(weights.begin(), weights.end());
+    centers.push_back(candidates[byWeight(gen)]);
+    while (static_cast<int>(centers.size()) < numClusters) {
+        double total = 0;
+        for (int j = 0; j < numCandidates; j++) {
+            d2[j] = std::min(d2[j], squaredDistance(candidates[j], centers.back()));
+            score[j] = weights[j] * d2[j];
+            total += score[j];
+        }
+        if (total <= 0) {
+            centers.push_back(candidates[byWeight(gen)]);
+            continue;
+        }
+        std::discrete_distribution<int> byScore(score.begin(), score.end());
+        int best = 0;
+        double bestPotential = INFINITY;
+        for (int t = 0; t < trials; t++) {
+            int candidate = byScore(gen);
+            double potential = 0;
+            for (int j = 0; j < numCandidates; j++) {
+                potential += weights[j] * std::min(d2[j], squaredDistance(candidates[j], candidates[candidate]));
+            }
+            if (potential < bestPotential) {
+                bestPotential = potential;
+                best = candidate;
+            }
+        }
+        centers.push_back(candidates[best]);
+    }
+
+    for (int it = 0; it < 5; it++) {
+        std::vector<double> sumX(numClusters, 0), sumY(numClusters, 0), count(numClusters, 0);
+        for (int j = 0; j < numCandidates; j++) {
+            int best = 0;
+            double minDist = INFINITY;
+            for (int c = 0; c < numClusters; c++) {
+                double dist = squaredDistance(candidates[j], centers[c]);
+                if (dist < minDist) {
+                    minDist = dist;
+                    best = c;
+                }
+            }
+            sumX[best] += weights[j] * candidates[j].x;
+            sumY[best] += weights[j] * candidates[j].y;
+            count[best] += weights[j];
+        }
+        for (int c = 0; c < numClusters; c++) {
+            if (count[c] > 0) {
+                centers[c].x = sumX[c] / count[c];
+                centers[c].y = sumY[c] / count[c];
+            }
+        }
+    }
+    return centers;
+}
+
+// k-means||: a ogni round ogni punto diventa candidato in modo indipendente con probabilità
+// oversampling * d2 / costo totale, quindi un round è una sola passata parallela sui punti.
+// Ogni candidato viene pesato con il numero di punti a cui è più vicino
+inline std::vector<point> seedKmeansParallel(const std::vector<point> &points, int numClusters,
+                                             unsigned long long seed, int rounds = 5, double oversampling = 0) {
+    if (points.empty()) {
+        return {};
+    }
+    if (oversampling <= 0) {
+        oversampling = 2.0 * numClusters;
+    }
+    std::size_t n = points.size();
+    std::mt19937_64 gen(seed);
+    std::vector<double> d2(n, INFINITY);
+    std::vector<int> nearest(n, 0);
+    std::vector<double> sums;
+
+    std::vector<point> candidates;
+    candidates.push_back(points[std::uniform_int_distribution<std::size_t>(0, n - 1)(gen)]);
+    updateNearest(points, candidates, 0, d2, nearest);
+
+    std::vector<std::vector<point>> sampled(seedingChunks);
+    for (int r = 0; r < rounds; r++) {
+        double total = chunkSums(d2, sums);
+        if (total <= 0) {
+            break;
+        }
+#pragma omp parallel for schedule(dynamic, 4)
+        for (int c = 0; c < seedingChunks; c++) {
+            std::seed_seq seq{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32),
+                              static_cast<std::uint32_t>(r), static_cast<std::uint32_t>(c)};
+            std::mt19937_64 chunkGen(seq);
+            std::uniform_real_distribution<double> coin(0, 1);
+            sampled[c].clear();
+            for (std::size_t i = seedingChunkBegin(n, c); i < seedingChunkBegin(n, c + 1); i++) {
+                if (coin(chunkGen) < oversampling * d2[i] / total) {
+                    sampled[c].push_back(points[i]);
+                }
+            }
+        }
+        std::size_t first = candidates.size();
+        for (const auto &chunk: sampled) {
+            candidates.insert(candidates.end(), chunk.begin(), chunk.end());
+        }
+        updateNearest(points, candidates, first, d2, nearest);
+    }
+
+    if (static_cast<int>(candidates.size()) <= numClusters) {
+        return seedKmeansPlusPlus(points, numClusters, seed);
+    }
+
+    // Conteggi interi per thread: la somma non dipende dall'ordine
+    std::vector<long long> weights(candidates.size(), 0);
+#pragma omp parallel
+    {
+        std::vector<long long> local(candidates.size(), 0);
+#pragma omp for schedule(static) nowait
+        for (std::size_t i = 0; i < n; i++) {
+            local[nearest[i]]++;
+        }
+#pragma omp critical
+        for (std::size_t j = 0; j < local.size(); j++) {
+            weights[j] += local[j];
+        }
+    }
+
+    std::cout << "[Seq] k-means||: " << candidates.size() << " candidati in " << rounds << " round" << std::endl;
+    return reduceCandidates(candidates, weights, numClusters, gen);
+}
+
+#endif // KMEANS_SEEDING_H
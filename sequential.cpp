@@ -7,154 +7,51 @@
 #include <sstream>
 #include <SFML/Graphics.hpp>
 #include <chrono>
-
-
-struct point {
-    double x;
-    double y;
-    int clusterID;
+#include "kmeans.h"
+#include "lloyd.h"
+#include "telemetry.h"
+#include "dataset_parser.h"
+#include "model.h"
+#include "dataset_generator.h"
+#include "elkan.h"
+#include "yinyang.h"
+#include "kdtree.h"
+#include "minibatch.h"
+#include "seeding.h"
+#include "renderer.h"
+
+
+// Algoritmo usato per k-means
+enum class kmeanAlgorithm {
+    lloyd, // assegnazione completa a ogni iterazione
+    elkan, // disuguaglianza triangolare con limiti per punto (elkan.h)
+    yinyang, // limiti per gruppo di centroidi, per K grandi (yinyang.h)
+    kdtree, // filtraggio su albero k-d costruito una volta sui punti (kdtree.h)
+    minibatch // batch letti dal file, senza caricare il dataset (minibatch.h)
 };
 
-class cluster {
-
-private:
-    point centroid{};
-    std::vector<point> points;
-    double totalX = 0;
-    double totalY = 0;
-    int count = 0;
-
-public:
-
-    void addTotalX(double x) {
-        totalX += x;
-    }
-
-    void addTotalY(double y) {
-        totalY += y;
-    }
-
-    void countPoints() {
-        count++;
-    }
-
-    void resetCountPoints() {
-        count = 0;
-    }
-
-    void resetTotalX() {
-        totalX = 0;
-    }
-
-    void resetTotalY() {
-        totalY = 0;
-    }
-
-
-    void createCentroid(point c) {
-        centroid = c;
-    }
-
-    void updateCentroid() {
-        if (count > 0) {
-            centroid.x = totalX / count;
-            centroid.y = totalY / count;
-        } else {
-            // Se non ci sono punti assegnati al cluster, mantieni il centroide invariato
-        }
-    }
-
-    point getCentroid() {
-        return centroid;
-    }
-};
-
-void generateDataset(int numPointsPerCluster, int numClusters, int centerDist, int stdDev, int rangeX, int rangeY) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-
-    std::ofstream outFile("../dataset/dataset.txt");
-    if (!outFile) {
+void generateDataset(int numPointsPerCluster, int numClusters, int centerDist, int stdDev, int rangeX, int rangeY,
+                     unsigned long long seed) {
+    // Stesso seme, stesso dataset, qualunque sia il numero di thread
+    std::cout << "[Seq] Generazione dataset con seme " << seed << std::endl;
+    if (!generateDatasetFile("../dataset/dataset.txt", numPointsPerCluster, numClusters, centerDist, stdDev,
+                             rangeX, rangeY, seed, false)) {
         std::cerr << "[Seq] Errore nell'apertura del file" << std::endl;
         return;
     }
-
-    std::vector<point> centers;
-
-    // Genera posizioni casuali per i centroidi
-    std::uniform_real_distribution<double> cenX(-rangeX, rangeX); // Intervallo per le coordinate x
-    std::uniform_real_distribution<double> cenY(-rangeY, rangeY); // Intervallo per le coordinate y
-
-    for (int i = 0; i < numClusters; ++i) {
-        point center;
-        bool validPos = false;
-
-        // Trova una posizione valida per il centroide
-        while (!validPos) {
-            double x = cenX(gen);
-            double y = cenY(gen);
-            center.x = x;
-            center.y = y;
-
-            validPos = true;
-
-            // Controlla se il nuovo centroide si sovrappone con quelli già generati
-            for (const auto &existingCenter: centers) {
-                if (std::sqrt(std::pow(existingCenter.x - x, 2) + std::pow(existingCenter.y - y, 2)) < centerDist) {
-                    validPos = false;
-                    break;
-                }
-            }
-        }
-        std::cout << "[Seq] Centri posizionati: " << i+1 <<std::endl;
-        centers.push_back(center); // Aggiungi il nuovo centroide alla lista dei centroidi validi
-
-        // Genera punti intorno al centroide con distribuzione normale
-        std::normal_distribution<double> disX(center.x, stdDev);
-        std::normal_distribution<double> disY(center.y, stdDev);
-
-        for (int j = 0; j < numPointsPerCluster; ++j) {
-            double x = disX(gen);
-            double y = disY(gen);
-            outFile << x << " " << y << std::endl;
-        }
-    }
-
-    outFile.close();
     std::cout << "[Seq] Dataset generato con successo" << std::endl;
 }
 
 std::vector<point> extractDataset() {
     std::vector<point> points;
-    std::ifstream inFile("../dataset/dataset.txt");
-
-    if (!inFile) {
+    if (!parseDatasetAoS("../dataset/dataset.txt", points)) {
         std::cerr << "[Seq] Errore nell'apertura del file" << std::endl;
-        return points;
     }
-
-    std::string line;
-    point p{};
-    while (std::getline(inFile, line)) {
-        std::istringstream iss(line);
-        iss >> p.x >> p.y; // Assegno al punto p le coordinate x e y
-        p.clusterID = -1;
-        points.push_back(p);
-    }
-
-    inFile.close();
     return points;
 }
 
-void createClusters(int numCluster, int rangeX, int rangeY, int centerDist) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-
-    std::ofstream outFile("../dataset/centroids.txt");
-    if (!outFile) {
-        std::cerr << "[Seq] Errore nell'apertura del file dei dati" << std::endl;
-        return;
-    }
+std::vector<point> randomCentroids(int numCluster, int rangeX, int rangeY, int centerDist, unsigned long long seed) {
+    std::mt19937 gen(seed);
 
     // Creazione centroidi
     std::uniform_real_distribution<double> disX(-rangeX, rangeX);
@@ -180,11 +77,47 @@ void createClusters(int numCluster, int rangeX, int rangeY, int centerDist) {
                 }
             }
         }
-
-        outFile << c.x << " " << c.y << std::endl;
         centroids.push_back(c);
     }
+    return centroids;
+}
+
+// Sceglie i centroidi iniziali, li salva in centroids.txt (letto anche dalle altre versioni)
+// e li restituisce già pronti per kmean, senza rileggere il file
+std::vector<cluster> createClusters(const std::vector<point> &points, int numCluster, int rangeX, int rangeY,
+                                    int centerDist, seedingMethod method, unsigned long long seed) {
+    // k-means++ e k-means|| partono dai punti: in modalità mini-batch non sono in memoria
+    if (points.empty() && method != seedingMethod::random) {
+        std::cout << "[Seq] Nessun punto caricato, centroidi casuali" << std::endl;
+        method = seedingMethod::random;
+    }
+
+    std::vector<point> centroids;
+    switch (method) {
+        case seedingMethod::random:
+            centroids = randomCentroids(numCluster, rangeX, rangeY, centerDist, seed);
+            break;
+        case seedingMethod::kmeansPlusPlus:
+            centroids = seedKmeansPlusPlus(points, numCluster, seed);
+            break;
+        case seedingMethod::kmeansParallel:
+            centroids = seedKmeansParallel(points, numCluster, seed);
+            break;
+    }
+
+    std::vector<cluster> clusters;
+    std::ofstream outFile("../dataset/centroids.txt");
+    if (!outFile) {
+        std::cerr << "[Seq] Errore nell'apertura del file dei dati" << std::endl;
+    }
+    for (auto &centroid: centroids) {
+        outFile << centroid.x << " " << centroid.y << std::endl;
+        cluster c{};
+        c.createCentroid(centroid);
+        clusters.push_back(c);
+    }
     outFile.close();
+    return clusters;
 }
 
 std::vector<cluster> extractClusters() {
@@ -210,160 +143,11 @@ std::vector<cluster> extractClusters() {
     return clusters;
 }
 
-std::vector<cluster> kmean(std::vector<cluster> &clusters, std::vector<point> &points, int maxIter) {
-    bool centerUpdated;
-    int minIndex;
-    double minDist;
-    double dist;
-    int i = 0;
-
-    do {
-        centerUpdated = false;
-        if (i % 10 == 0)
-            std::cout << "[Seq] Numero iterazioni k-means: " << i << std::endl;
-        i++;
-
-        for (auto &cluster: clusters) {
-
-            // reset valori in ogni cluster
-            cluster.resetTotalX();
-            cluster.resetTotalY();
-            cluster.resetCountPoints();
-        }
-
-        for (auto &point: points) {
-            minDist = INFINITY;
-            for (int j = 0; j < clusters.size(); j++) {
-                dist = std::sqrt(std::pow(clusters[j].getCentroid().x - point.x, 2) + std::pow(clusters[j].getCentroid().y - point.y, 2));
-                if (dist < minDist) {
-                    minDist = dist;
-                    minIndex = j;
-                }
-            }
-            if (point.clusterID != minIndex) {
-                centerUpdated = true; // Se nessun punto cambia cluster allora termino
-            }
-            point.clusterID = minIndex;
-            clusters[minIndex].addTotalX(point.x);
-            clusters[minIndex].addTotalY(point.y);
-            clusters[minIndex].countPoints();
-        }
-
-        if (centerUpdated) {
-            for (auto &cluster: clusters) {
-                cluster.updateCentroid();
-            }
-        }
-    } while (centerUpdated && i <= maxIter);
-
-    return clusters;
-}
-
 void drawPoints(sf::RenderWindow &window, std::vector<point> &points, std::vector<point> &centroids) {
-    // Imposta l'origine della vista al centro della finestra
-    sf::View view = window.getDefaultView();
-    view.setCenter(window.getSize().x / 2, window.getSize().y / 2);
-    window.setView(view);
-    while (window.isOpen()) {
-
-        sf::Event event{};
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed) {
-                window.close();
-            }
-        }
-
-        window.clear(sf::Color::White);
-
-        // Disegna l'asse delle x
-        sf::VertexArray xAxis(sf::Lines, 2);
-        xAxis[0].position = sf::Vector2f(0, window.getSize().y / 2);
-        xAxis[1].position = sf::Vector2f(window.getSize().x, window.getSize().y / 2);
-        xAxis[0].color = sf::Color::Black;
-        xAxis[1].color = sf::Color::Black;
-
-        // Disegna l'asse delle y
-        sf::VertexArray yAxis(sf::Lines, 2);
-        yAxis[0].position = sf::Vector2f(window.getSize().x / 2, 0);
-        yAxis[1].position = sf::Vector2f(window.getSize().x / 2, window.getSize().y);
-        yAxis[0].color = sf::Color::Black;
-        yAxis[1].color = sf::Color::Black;
-
-        // Importa il font
-        sf::Font font;
-        if (!font.loadFromFile("../font/arial.ttf")) {
-            std::cerr << "[Seq] Impossibile caricare il font Arial." << std::endl;
-            return;
-        }
-
-        // Etichetta sull'asse x
-        sf::Text xAxisLabel("x", font, 16);
-        xAxisLabel.setFillColor(sf::Color::Black);
-        xAxisLabel.setPosition(window.getSize().x - 20, window.getSize().y / 2 + 10);
-
-        // Etichetta sull'asse y
-        sf::Text yAxisLabel("y", font, 16);
-        yAxisLabel.setFillColor(sf::Color::Black);
-        yAxisLabel.setPosition(window.getSize().x / 2 + 10, 10);
-
-        window.draw(xAxis);
-        window.draw(yAxis);
-        window.draw(xAxisLabel);
-        window.draw(yAxisLabel);
-
-        // Disegna i punti
-        sf::CircleShape pointShape(1); // Imposta la forma del punto
-
-        for (auto &point: points) { // Ogni punto ha un colore associato al cluster
-            switch (point.clusterID) {
-                case 0:
-                    pointShape.setFillColor(sf::Color::Red);
-                    break;
-                case 1:
-                    pointShape.setFillColor(sf::Color::Blue);
-                    break;
-                case 2:
-                    pointShape.setFillColor(sf::Color::Green);
-                    break;
-                case 3:
-                    pointShape.setFillColor(sf::Color::Yellow);
-                    break;
-                case 4:
-                    pointShape.setFillColor(sf::Color::Magenta);
-                    break;
-                case 5:
-                    pointShape.setFillColor(sf::Color::Cyan);
-                    break;
-                case 6:
-                    pointShape.setFillColor(sf::Color(255, 182, 193)); // rosa
-                    break;
-                case 7:
-                    pointShape.setFillColor(sf::Color(165, 42, 42)); // marrone
-                    break;
-                case 8:
-                    pointShape.setFillColor(sf::Color(128, 128, 128)); // grigio
-                    break;
-                case 9:
-                    pointShape.setFillColor(sf::Color(128, 0, 128)); //viola
-                    break;
-
-            }
-
-            pointShape.setPosition(point.x + window.getSize().x / 2, window.getSize().y / 2 - point.y);
-            window.draw(pointShape);
-        }
-
-        // Disegna i centroidi
-        sf::CircleShape centroidShape(3);
-        centroidShape.setFillColor(sf::Color::Black);
-
-        for (auto &centroid: centroids) {
-            centroidShape.setPosition(centroid.x + window.getSize().x / 2, window.getSize().y / 2 - centroid.y);
-            window.draw(centroidShape);
-        }
-
-        window.display();
-    }
+    clusterRenderer renderer("[Seq]", window.getSize());
+    renderer.setPoints(points);
+    renderer.setCentroids(centroids);
+    renderer.run(window);
 }
 
 int main() {
@@ -375,38 +159,97 @@ int main() {
     int rangeX = 700;
     int rangeY = 350;
     bool changeDataset = false;
+    unsigned long long datasetSeed = std::random_device{}();
     bool changeCentroids = false;
+    seedingMethod seeding = seedingMethod::kmeansParallel; // usato solo se changeCentroids è true
+    unsigned long long seedingSeed = std::random_device{}();
     int maxIter = 150;
+    std::string telemetryPath; // ad esempio "../dataset/telemetry.jsonl": statistiche di ogni iterazione di Lloyd
+    std::string modelPath = "../dataset/model.kmm"; // vuoto: il modello per predict non viene salvato
+    kmeanAlgorithm algorithm = kmeanAlgorithm::lloyd;
+    miniBatchParams batchParams; // dimensione dei batch e criterio di arresto per la modalità mini-batch
 
     std::cout << "[Seq] Versione sequenziale kmeans\n" << std::endl;
 
     if (changeDataset) {
         generateDataset(numPointsPerCluster, numCluster, centerDist, stdDev, rangeX,
-                        rangeY);
+                        rangeY, datasetSeed);
+    }
+    // In modalità mini-batch i punti vengono letti dal file a blocchi e non restano in memoria
+    std::vector<point> points;
+    if (algorithm != kmeanAlgorithm::minibatch) {
+        points = extractDataset();
+    }
+
+    // L'albero k-d dipende solo dai punti: viene costruito una volta, fuori dal tempo di k-means
+    kdTree tree;
+    if (algorithm == kmeanAlgorithm::kdtree) {
+        std::chrono::steady_clock::time_point build_start = std::chrono::steady_clock::now();
+        tree = buildKdTree(points);
+        std::chrono::duration<double> build_seconds = std::chrono::steady_clock::now() - build_start;
+        std::cout << "[Seq] Albero k-d costruito (" << tree.nodes.size() << " nodi) in " << build_seconds.count()
+                  << " secondi" << std::endl;
     }
-    std::vector<point> points = extractDataset();
 
     // creazione cluster
+    std::vector<cluster> clusters;
     if (changeCentroids) {
-        createClusters(numCluster, rangeX, rangeY, centerDist);
+        std::chrono::steady_clock::time_point seed_start = std::chrono::steady_clock::now();
+        clusters = createClusters(points, numCluster, rangeX, rangeY, centerDist, seeding, seedingSeed);
+        std::chrono::duration<double> seed_seconds = std::chrono::steady_clock::now() - seed_start;
+        std::cout << "[Seq] Centroidi iniziali scelti (seme " << seedingSeed << ") in " << seed_seconds.count()
+                  << " secondi" << std::endl;
+    } else {
+        clusters = extractClusters();
     }
-    std::vector<cluster> clusters = extractClusters();
 
     std::vector<point> centroids;
     centroids.reserve(clusters.size());
 
+    // Il file di telemetria viene aperto prima della misura del tempo
+    telemetryLog telemetry;
+    bool telemetryOn = algorithm == kmeanAlgorithm::lloyd && !telemetryPath.empty() && telemetry.open(telemetryPath);
+    telemetry.setRun("seq");
+
     std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
 
-    clusters = kmean(clusters, points, maxIter);
+    std::vector<long long> skippedDistances;
+    switch (algorithm) {
+        case kmeanAlgorithm::lloyd: {
+            clusters = kmeanSequential(clusters, points, maxIter, nullptr, 0, telemetryOn ? &telemetry : nullptr);
+            break;
+        }
+        case kmeanAlgorithm::elkan:
+            clusters = kmeanElkan(clusters, points, maxIter, skippedDistances);
+            break;
+        case kmeanAlgorithm::yinyang:
+            clusters = kmeanYinyang(clusters, points, maxIter, skippedDistances);
+            break;
+        case kmeanAlgorithm::kdtree:
+            clusters = kmeanKdTree(clusters, points, tree, maxIter, skippedDistances);
+            break;
+        case kmeanAlgorithm::minibatch:
+            clusters = kmeanMiniBatch(clusters, "../dataset/dataset.txt", batchParams);
+            break;
+    }
 
     std::chrono::steady_clock::time_point end_time = std::chrono::steady_clock::now();
     std::chrono::duration<double> elapsed_seconds = end_time - start_time;
     std::cout << "[Seq] Tempo impiegato da k-means: " << elapsed_seconds.count() << " secondi" << std::endl;
 
+    for (std::size_t it = 0; it < skippedDistances.size(); it++) {
+        std::cout << "[Seq] Iterazione " << it << ", distanze evitate: " << skippedDistances[it] << " su "
+                  << points.size() * clusters.size() << std::endl;
+    }
+
     for (auto &cluster: clusters) {
         centroids.push_back(cluster.getCentroid());
     }
 
+    if (!modelPath.empty() && writeModel(modelPath, makeModel(centroids, "sequential", points.size()))) {
+        std::cout << "[Seq] Modello salvato in " << modelPath << std::endl;
+    }
+
     sf::RenderWindow window(sf::VideoMode(1600, 1200), "Sequential clusters");
     drawPoints(window, points, centroids);
 
@@ -0,0 +1,371 @@
+//
+// Kernel di assegnazione per il layout SoA: distanza al quadrato e argmin senza salti
+// su 2/4/8 punti per volta, con scelta a runtime tra SSE2, AVX2 e AVX-512 in base alla CPU.
+//
+
+#ifndef KMEANS_SOA_KERNEL_H
+#define KMEANS_SOA_KERNEL_H
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define KMEANS_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// Con GCC/Clang ogni variante viene compilata per il proprio set di istruzioni senza
+// cambiare i flag del target; MSVC accetta gli intrinsics senza attributi
+#if defined(__GNUC__)
+#define KMEANS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define KMEANS_TARGET(isa)
+#endif
+
+// Assegna i punti [begin, end) al centroide più vicino, aggiorna points_id e somma
+// coordinate e conteggi in totalX, totalY e countPoints (che non vengono azzerati).
+// Le varianti delta (parametro del template) sommano solo le variazioni: un punto che passa dal
+// cluster a al cluster b viene tolto da a e aggiunto a b, i punti che non cambiano non toccano le somme.
+// laneScratch è un buffer del chiamante di assignScratchSize(numCluster) double azzerati: il kernel
+// AVX-512 completo vi tiene le somme per lane e lo lascia azzerato, così si alloca una volta per esecuzione.
+// Ritorna true se almeno un punto ha cambiato cluster
+typedef bool (*assignKernel)(const double *x_values, const double *y_values, int *points_id,
+                             std::size_t begin, std::size_t end,
+                             const double *x_centroids, const double *y_centroids, int numCluster,
+                             double *totalX, double *totalY, int *countPoints, double *laneScratch);
+
+// Double di laneScratch per numCluster cluster: x, y e conteggio per ognuna delle 8 lane AVX-512
+inline std::size_t assignScratchSize(int numCluster) {
+    return static_cast<std::size_t>(numCluster) * 8 * 3;
+}
+
+// Sposta il punto j dal cluster from (-1 se non era assegnato) al cluster to
+inline void movePoint(const double *x_values, const double *y_values, std::size_t j, int from, int to,
+                      double *totalX, double *totalY, int *countPoints) {
+    if (from >= 0) {
+        totalX[from] -= x_values[j];
+        totalY[from] -= y_values[j];
+        countPoints[from]--;
+    }
+    totalX[to] += x_values[j];
+    totalY[to] += y_values[j];
+    countPoints[to]++;
+}
+
+// Gestisce un singolo punto: usata dalla versione scalare e per la coda dei kernel SIMD
+template<bool delta>
+inline bool assignPoint(const double *x_values, const double *y_values, int *points_id, std::size_t j,
+                        const double *x_centroids, const double *y_centroids, int numCluster,
+                        double *totalX, double *totalY, int *countPoints) {
+    double minDist = INFINITY;
+    int minIndex = 0;
+    for (int k = 0; k < numCluster; k++) {
+        double dx = x_centroids[k] - x_values[j];
+        double dy = y_centroids[k] - y_values[j];
+        double dist = dx * dx + dy * dy; // la radice non cambia l'ordinamento
+        if (dist < minDist) {
+            minDist = dist;
+            minIndex = k;
+        }
+    }
+    bool changed = points_id[j] != minIndex;
+    if constexpr (delta) {
+        if (changed) {
+            movePoint(x_values, y_values, j, points_id[j], minIndex, totalX, totalY, countPoints);
+        }
+    } else {
+        totalX[minIndex] += x_values[j];
+        totalY[minIndex] += y_values[j];
+        countPoints[minIndex]++;
+    }
+    points_id[j] = minIndex;
+    return changed;
+}
+
+template<bool delta>
+inline bool assignScalar(const double *x_values, const double *y_values, int *points_id,
+                         std::size_t begin, std::size_t end,
+                         const double *x_centroids, const double *y_centroids, int numCluster,
+                         double *totalX, double *totalY, int *countPoints, double *) {
+    bool changed = false;
+    for (std::size_t j = begin; j < end; j++) {
+        changed |= assignPoint<delta>(x_values, y_values, points_id, j, x_centroids, y_centroids, numCluster,
+                               totalX, totalY, countPoints);
+    }
+    return changed;
+}
+
+#ifdef KMEANS_X86
+
+// Variante delta di accumulateBlock: solo le lane il cui cluster è cambiato rispetto a previous
+inline void moveBlock(const double *x_values, const double *y_values, const int *previous, const int *points_id,
+                      std::size_t j, int lanes, double *totalX, double *totalY, int *countPoints) {
+    for (int l = 0; l < lanes; l++) {
+        if (previous[l] != points_id[j + l]) {
+            movePoint(x_values, y_values, j + l, previous[l], points_id[j + l], totalX, totalY, countPoints);
+        }
+    }
+}
+
+// Somma dei punti di un blocco nei cluster appena assegnati. SSE2 e AVX2 non hanno scatter,
+// quindi le lane vengono sommate una alla volta leggendo gli indici già salvati
+inline void accumulateBlock(const double *x_values, const double *y_values, const int *points_id,
+                            std::size_t j, int lanes, double *totalX, double *totalY, int *countPoints) {
+    for (int l = 0; l < lanes; l++) {
+        int id = points_id[j + l];
+        totalX[id] += x_values[j + l];
+        totalY[id] += y_values[j + l];
+        countPoints[id]++;
+    }
+}
+
+// SSE2: due vettori da 2 double, quindi 4 punti per passo
+template<bool delta>
+KMEANS_TARGET("sse2")
+inline bool assignSSE2(const double *x_values, const double *y_values, int *points_id,
+                       std::size_t begin, std::size_t end,
+                       const double *x_centroids, const double *y_centroids, int numCluster,
+                       double *totalX, double *totalY, int *countPoints, double *) {
+    bool changed = false;
+    std::size_t j = begin;
+    for (; j + 4 <= end; j += 4) {
+        __m128d px0 = _mm_loadu_pd(x_values + j);
+        __m128d py0 = _mm_loadu_pd(y_values + j);
+        __m128d px1 = _mm_loadu_pd(x_values + j + 2);
+        __m128d py1 = _mm_loadu_pd(y_values + j + 2);
+        __m128d best0 = _mm_set1_pd(INFINITY);
+        __m128d best1 = best0;
+        __m128d bestIdx0 = _mm_setzero_pd();
+        __m128d bestIdx1 = bestIdx0;
+
+        for (int k = 0; k < numCluster; k++) {
+            __m128d cx = _mm_set1_pd(x_centroids[k]);
+            __m128d cy = _mm_set1_pd(y_centroids[k]);
+            __m128d idx = _mm_set1_pd(k);
+
+            __m128d dx0 = _mm_sub_pd(cx, px0);
+            __m128d dy0 = _mm_sub_pd(cy, py0);
+            __m128d d0 = _mm_add_pd(_mm_mul_pd(dx0, dx0), _mm_mul_pd(dy0, dy0));
+            __m128d lt0 = _mm_cmplt_pd(d0, best0);
+            best0 = _mm_min_pd(d0, best0);
+            bestIdx0 = _mm_or_pd(_mm_and_pd(lt0, idx), _mm_andnot_pd(lt0, bestIdx0));
+
+            __m128d dx1 = _mm_sub_pd(cx, px1);
+            __m128d dy1 = _mm_sub_pd(cy, py1);
+            __m128d d1 = _mm_add_pd(_mm_mul_pd(dx1, dx1), _mm_mul_pd(dy1, dy1));
+            __m128d lt1 = _mm_cmplt_pd(d1, best1);
+            best1 = _mm_min_pd(d1, best1);
+            bestIdx1 = _mm_or_pd(_mm_and_pd(lt1, idx), _mm_andnot_pd(lt1, bestIdx1));
+        }
+
+        // Gli indici (interi esatti in double) vengono convertiti e confrontati con i precedenti
+        __m128i ids = _mm_unpacklo_epi64(_mm_cvtpd_epi32(bestIdx0), _mm_cvtpd_epi32(bestIdx1));
+        __m128i old = _mm_loadu_si128(reinterpret_cast<const __m128i *>(points_id + j));
+        bool blockChanged = _mm_movemask_epi8(_mm_cmpeq_epi32(ids, old)) != 0xFFFF;
+        changed |= blockChanged;
+        int previous[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(previous), old);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(points_id + j), ids);
+
+        if constexpr (delta) {
+            if (blockChanged) {
+                moveBlock(x_values, y_values, previous, points_id, j, 4, totalX, totalY, countPoints);
+            }
+        } else {
+            accumulateBlock(x_values, y_values, points_id, j, 4, totalX, totalY, countPoints);
+        }
+    }
+    for (; j < end; j++) {
+        changed |= assignPoint<delta>(x_values, y_values, points_id, j, x_centroids, y_centroids, numCluster,
+                               totalX, totalY, countPoints);
+    }
+    return changed;
+}
+
+// AVX2: 4 punti per passo
+template<bool delta>
+KMEANS_TARGET("avx2")
+inline bool assignAVX2(const double *x_values, const double *y_values, int *points_id,
+                       std::size_t begin, std::size_t end,
+                       const double *x_centroids, const double *y_centroids, int numCluster,
+                       double *totalX, double *totalY, int *countPoints, double *) {
+    bool changed = false;
+    std::size_t j = begin;
+    for (; j + 4 <= end; j += 4) {
+        __m256d px = _mm256_loadu_pd(x_values + j);
+        __m256d py = _mm256_loadu_pd(y_values + j);
+        __m256d best = _mm256_set1_pd(INFINITY);
+        __m256d bestIdx = _mm256_setzero_pd();
+
+        for (int k = 0; k < numCluster; k++) {
+            __m256d dx = _mm256_sub_pd(_mm256_broadcast_sd(x_centroids + k), px);
+            __m256d dy = _mm256_sub_pd(_mm256_broadcast_sd(y_centroids + k), py);
+            __m256d d = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+            __m256d lt = _mm256_cmp_pd(d, best, _CMP_LT_OQ);
+            best = _mm256_min_pd(d, best);
+            bestIdx = _mm256_blendv_pd(bestIdx, _mm256_set1_pd(k), lt);
+        }
+
+        __m128i ids = _mm256_cvtpd_epi32(bestIdx);
+        __m128i old = _mm_loadu_si128(reinterpret_cast<const __m128i *>(points_id + j));
+        bool blockChanged = _mm_movemask_epi8(_mm_cmpeq_epi32(ids, old)) != 0xFFFF;
+        changed |= blockChanged;
+        int previous[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(previous), old);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(points_id + j), ids);
+
+        if constexpr (delta) {
+            if (blockChanged) {
+                moveBlock(x_values, y_values, previous, points_id, j, 4, totalX, totalY, countPoints);
+            }
+        } else {
+            accumulateBlock(x_values, y_values, points_id, j, 4, totalX, totalY, countPoints);
+        }
+    }
+    for (; j < end; j++) {
+        changed |= assignPoint<delta>(x_values, y_values, points_id, j, x_centroids, y_centroids, numCluster,
+                               totalX, totalY, countPoints);
+    }
+    return changed;
+}
+
+// AVX-512: 8 punti per passo, argmin con maschere. Anche l'accumulo è vettoriale: ogni lane
+// ha le proprie somme per cluster in laneScratch (indice id * 8 + lane), quindi gather e scatter dello
+// stesso vettore non collidono mai. Le somme delle lane vengono ridotte e azzerate una volta sola alla fine
+template<bool delta>
+KMEANS_TARGET("avx512f")
+inline bool assignAVX512(const double *x_values, const double *y_values, int *points_id,
+                         std::size_t begin, std::size_t end,
+                         const double *x_centroids, const double *y_centroids, int numCluster,
+                         double *totalX, double *totalY, int *countPoints, double *laneScratch) {
+    bool changed = false;
+    // Le somme per lane servono solo alla versione completa: la variante delta sposta pochi punti
+    // e non usa laneScratch
+    double *laneX = nullptr;
+    double *laneY = nullptr;
+    double *laneCount = nullptr;
+    if constexpr (!delta) {
+        laneX = laneScratch;
+        laneY = laneX + numCluster * 8;
+        laneCount = laneY + numCluster * 8;
+    }
+    const __m256i laneOffset = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m512d one = _mm512_set1_pd(1.0);
+
+    std::size_t j = begin;
+    for (; j + 8 <= end; j += 8) {
+        __m512d px = _mm512_loadu_pd(x_values + j);
+        __m512d py = _mm512_loadu_pd(y_values + j);
+        __m512d best = _mm512_set1_pd(INFINITY);
+        __m512d bestIdx = _mm512_setzero_pd();
+
+        for (int k = 0; k < numCluster; k++) {
+            __m512d dx = _mm512_sub_pd(_mm512_set1_pd(x_centroids[k]), px);
+            __m512d dy = _mm512_sub_pd(_mm512_set1_pd(y_centroids[k]), py);
+            __m512d d = _mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy));
+            __mmask8 lt = _mm512_cmp_pd_mask(d, best, _CMP_LT_OQ);
+            best = _mm512_mask_blend_pd(lt, best, d);
+            bestIdx = _mm512_mask_blend_pd(lt, bestIdx, _mm512_set1_pd(k));
+        }
+
+        __m256i ids = _mm512_cvtpd_epi32(bestIdx);
+        __m256i old = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(points_id + j));
+        bool blockChanged = _mm256_movemask_epi8(_mm256_cmpeq_epi32(ids, old)) != -1;
+        changed |= blockChanged;
+        if constexpr (delta) {
+            if (blockChanged) {
+                int previous[8];
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(previous), old);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(points_id + j), ids);
+                moveBlock(x_values, y_values, previous, points_id, j, 8, totalX, totalY, countPoints);
+            }
+            continue;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(points_id + j), ids);
+
+        __m256i slot = _mm256_add_epi32(_mm256_slli_epi32(ids, 3), laneOffset);
+        _mm512_i32scatter_pd(laneX, slot, _mm512_add_pd(_mm512_i32gather_pd(slot, laneX, 8), px), 8);
+        _mm512_i32scatter_pd(laneY, slot, _mm512_add_pd(_mm512_i32gather_pd(slot, laneY, 8), py), 8);
+        _mm512_i32scatter_pd(laneCount, slot, _mm512_add_pd(_mm512_i32gather_pd(slot, laneCount, 8), one), 8);
+    }
+    if constexpr (!delta) {
+        for (int k = 0; k < numCluster; k++) {
+            for (int l = 0; l < 8; l++) {
+                totalX[k] += laneX[k * 8 + l];
+                totalY[k] += laneY[k * 8 + l];
+                countPoints[k] += static_cast<int>(laneCount[k * 8 + l]);
+                laneX[k * 8 + l] = 0;
+                laneY[k * 8 + l] = 0;
+                laneCount[k * 8 + l] = 0;
+            }
+        }
+    }
+    for (; j < end; j++) {
+        changed |= assignPoint<delta>(x_values, y_values, points_id, j, x_centroids, y_centroids, numCluster,
+                               totalX, totalY, countPoints);
+    }
+    return changed;
+}
+
+#if defined(_MSC_VER)
+// Con MSVC i bit di CPUID vanno letti a mano, verificando anche che il sistema operativo
+// salvi i registri estesi (XCR0)
+inline bool cpuHasFeature(int leaf, int reg, int bit, unsigned long long xcr0Mask) {
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < leaf) {
+        return false;
+    }
+    if (xcr0Mask != 0) {
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (!osxsave || (_xgetbv(0) & xcr0Mask) != xcr0Mask) {
+            return false;
+        }
+    }
+    __cpuidex(info, leaf, 0);
+    return (info[reg] & (1 << bit)) != 0;
+}
+#endif
+
+#endif // KMEANS_X86
+
+// Sceglie il kernel migliore supportato dalla CPU su cui gira il programma, completo o delta
+inline assignKernel selectAssignKernel(const char **name, bool delta = false) {
+#if defined(KMEANS_X86) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        *name = "AVX-512";
+        return delta ? assignAVX512<true> : assignAVX512<false>;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        *name = "AVX2";
+        return delta ? assignAVX2<true> : assignAVX2<false>;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        *name = "SSE2";
+        return delta ? assignSSE2<true> : assignSSE2<false>;
+    }
+#elif defined(KMEANS_X86) && defined(_MSC_VER)
+    if (cpuHasFeature(7, 1, 16, 0xE6)) { // EBX bit 16: AVX-512F, stato ZMM abilitato
+        *name = "AVX-512";
+        return delta ? assignAVX512<true> : assignAVX512<false>;
+    }
+    if (cpuHasFeature(7, 1, 5, 0x6)) { // EBX bit 5: AVX2, stato YMM abilitato
+        *name = "AVX2";
+        return delta ? assignAVX2<true> : assignAVX2<false>;
+    }
+    if (cpuHasFeature(1, 3, 26, 0)) { // EDX bit 26: SSE2
+        *name = "SSE2";
+        return delta ? assignSSE2<true> : assignSSE2<false>;
+    }
+#endif
+    *name = "scalare";
+    return delta ? assignScalar<true> : assignScalar<false>;
+}
+
+#endif // KMEANS_SOA_KERNEL_H
@@ -0,0 +1,292 @@
+//
+// Kernel di assegnazione SoA in singola precisione: punti e centroidi float dimezzano i byte letti a ogni
+// iterazione e raddoppiano i punti per istruzione (4/8/16 con SSE2/AVX2/AVX-512). Le somme per cluster
+// sono a blocchi: ogni blocco di floatBlockSize punti viene sommato in float e il risultato del blocco
+// entra in una somma compensata di Kahan, così i centroidi restano vicini a quelli della versione double.
+//
+
+#ifndef KMEANS_SOA_KERNEL_FLOAT_H
+#define KMEANS_SOA_KERNEL_FLOAT_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "soa_kernel.h"
+
+// Somma compensata (Kahan): comp conserva i bit persi a ogni addizione.
+// Non va compilata con -ffast-math, che permette al compilatore di eliminare la compensazione
+struct kahanSum {
+    float sum = 0;
+    float comp = 0;
+
+    void add(float value) {
+        float y = value - comp;
+        float t = sum + y;
+        comp = (t - sum) - y;
+        sum = t;
+    }
+
+    double value() const {
+        return static_cast<double>(sum) - static_cast<double>(comp);
+    }
+};
+
+typedef bool (*assignKernelFloat)(const float *x_values, const float *y_values, int *points_id,
+                                  std::size_t begin, std::size_t end,
+                                  const float *x_centroids, const float *y_centroids, int numCluster,
+                                  kahanSum *totalX, kahanSum *totalY, int *countPoints);
+
+// Kernel su un solo blocco: somma le coordinate in sumX e sumY (float, non azzerate).
+// laneSums (2 * lanes * numCluster) e laneCount (lanes * numCluster) sono le somme per lane dei kernel
+// che ne hanno bisogno: arrivano azzerate e il kernel le lascia azzerate, così si allocano una volta
+typedef bool (*blockKernelFloat)(const float *x_values, const float *y_values, int *points_id,
+                                 std::size_t begin, std::size_t end,
+                                 const float *x_centroids, const float *y_centroids, int numCluster,
+                                 float *sumX, float *sumY, int *countPoints, float *laneSums, int *laneCount);
+
+// Punti per blocco: in un blocco ogni somma riceve al più un migliaio di addizioni in float
+const std::size_t floatBlockSize = 1024;
+
+inline bool assignPointFloat(const float *x_values, const float *y_values, int *points_id, std::size_t j,
+                             const float *x_centroids, const float *y_centroids, int numCluster,
+                             float *sumX, float *sumY, int *countPoints) {
+    float minDist = INFINITY;
+    int minIndex = 0;
+    for (int k = 0; k < numCluster; k++) {
+        float dx = x_centroids[k] - x_values[j];
+        float dy = y_centroids[k] - y_values[j];
+        float dist = dx * dx + dy * dy;
+        if (dist < minDist) {
+            minDist = dist;
+            minIndex = k;
+        }
+    }
+    bool changed = points_id[j] != minIndex;
+    points_id[j] = minIndex;
+    sumX[minIndex] += x_values[j];
+    sumY[minIndex] += y_values[j];
+    countPoints[minIndex]++;
+    return changed;
+}
+
+inline bool blockScalarFloat(const float *x_values, const float *y_values, int *points_id,
+                             std::size_t begin, std::size_t end,
+                             const float *x_centroids, const float *y_centroids, int numCluster,
+                             float *sumX, float *sumY, int *countPoints, float *, int *) {
+    bool changed = false;
+    for (std::size_t j = begin; j < end; j++) {
+        changed |= assignPointFloat(x_values, y_values, points_id, j, x_centroids, y_centroids, numCluster,
+                                    sumX, sumY, countPoints);
+    }
+    return changed;
+}
+
+// Divide [begin, end) in blocchi, esegue il kernel su ognuno e aggiunge le somme del blocco ai totali compensati.
+// lanes è il numero di lane con somme separate del kernel (0 se non ne usa): i buffer vengono allocati
+// una volta per chiamata e riusati da tutti i blocchi
+template<blockKernelFloat kernel, int lanes = 0>
+bool assignCompensated(const float *x_values, const float *y_values, int *points_id,
+                       std::size_t begin, std::size_t end,
+                       const float *x_centroids, const float *y_centroids, int numCluster,
+                       kahanSum *totalX, kahanSum *totalY, int *countPoints) {
+    std::vector<float> blockSums(2 * numCluster);
+    std::vector<float> laneSums(2 * lanes * numCluster, 0.0f);
+    std::vector<int> laneCount(lanes * numCluster, 0);
+    float *sumX = blockSums.data();
+    float *sumY = sumX + numCluster;
+    bool changed = false;
+    for (std::size_t first = begin; first < end; first += floatBlockSize) {
+        std::size_t last = std::min(first + floatBlockSize, end);
+        std::fill(blockSums.begin(), blockSums.end(), 0.0f);
+        changed |= kernel(x_values, y_values, points_id, first, last, x_centroids, y_centroids, numCluster,
+                          sumX, sumY, countPoints, laneSums.data(), laneCount.data());
+        for (int k = 0; k < numCluster; k++) {
+            totalX[k].add(sumX[k]);
+            totalY[k].add(sumY[k]);
+        }
+    }
+    return changed;
+}
+
+#ifdef KMEANS_X86
+
+inline void accumulateBlockFloat(const float *x_values, const float *y_values, const int *points_id,
+                                 std::size_t j, int lanes, float *sumX, float *sumY, int *countPoints) {
+    for (int l = 0; l < lanes; l++) {
+        int id = points_id[j + l];
+        sumX[id] += x_values[j + l];
+        sumY[id] += y_values[j + l];
+        countPoints[id]++;
+    }
+}
+
+// SSE2: 4 punti per passo
+KMEANS_TARGET("sse2")
+inline bool blockSSE2Float(const float *x_values, const float *y_values, int *points_id,
+                           std::size_t begin, std::size_t end,
+                           const float *x_centroids, const float *y_centroids, int numCluster,
+                           float *sumX, float *sumY, int *countPoints, float *, int *) {
+    bool changed = false;
+    std::size_t j = begin;
+    for (; j + 4 <= end; j += 4) {
+        __m128 px = _mm_loadu_ps(x_values + j);
+        __m128 py = _mm_loadu_ps(y_values + j);
+        __m128 best = _mm_set1_ps(INFINITY);
+        __m128 bestIdx = _mm_setzero_ps();
+
+        for (int k = 0; k < numCluster; k++) {
+            __m128 dx = _mm_sub_ps(_mm_set1_ps(x_centroids[k]), px);
+            __m128 dy = _mm_sub_ps(_mm_set1_ps(y_centroids[k]), py);
+            __m128 d = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            __m128 lt = _mm_cmplt_ps(d, best);
+            best = _mm_min_ps(d, best);
+            bestIdx = _mm_or_ps(_mm_and_ps(lt, _mm_set1_ps(k)), _mm_andnot_ps(lt, bestIdx));
+        }
+
+        // Gli indici sono interi esatti in float fino a 2^24 cluster
+        __m128i ids = _mm_cvtps_epi32(bestIdx);
+        __m128i old = _mm_loadu_si128(reinterpret_cast<const __m128i *>(points_id + j));
+        changed |= _mm_movemask_epi8(_mm_cmpeq_epi32(ids, old)) != 0xFFFF;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(points_id + j), ids);
+
+        accumulateBlockFloat(x_values, y_values, points_id, j, 4, sumX, sumY, countPoints);
+    }
+    for (; j < end; j++) {
+        changed |= assignPointFloat(x_values, y_values, points_id, j, x_centroids, y_centroids, numCluster,
+                                    sumX, sumY, countPoints);
+    }
+    return changed;
+}
+
+// AVX2: 8 punti per passo
+KMEANS_TARGET("avx2")
+inline bool blockAVX2Float(const float *x_values, const float *y_values, int *points_id,
+                           std::size_t begin, std::size_t end,
+                           const float *x_centroids, const float *y_centroids, int numCluster,
+                           float *sumX, float *sumY, int *countPoints, float *, int *) {
+    bool changed = false;
+    std::size_t j = begin;
+    for (; j + 8 <= end; j += 8) {
+        __m256 px = _mm256_loadu_ps(x_values + j);
+        __m256 py = _mm256_loadu_ps(y_values + j);
+        __m256 best = _mm256_set1_ps(INFINITY);
+        __m256 bestIdx = _mm256_setzero_ps();
+
+        for (int k = 0; k < numCluster; k++) {
+            __m256 dx = _mm256_sub_ps(_mm256_broadcast_ss(x_centroids + k), px);
+            __m256 dy = _mm256_sub_ps(_mm256_broadcast_ss(y_centroids + k), py);
+            __m256 d = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            __m256 lt = _mm256_cmp_ps(d, best, _CMP_LT_OQ);
+            best = _mm256_min_ps(d, best);
+            bestIdx = _mm256_blendv_ps(bestIdx, _mm256_set1_ps(k), lt);
+        }
+
+        __m256i ids = _mm256_cvtps_epi32(bestIdx);
+        __m256i old = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(points_id + j));
+        changed |= _mm256_movemask_epi8(_mm256_cmpeq_epi32(ids, old)) != -1;
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(points_id + j), ids);
+
+        accumulateBlockFloat(x_values, y_values, points_id, j, 8, sumX, sumY, countPoints);
+    }
+    for (; j < end; j++) {
+        changed |= assignPointFloat(x_values, y_values, points_id, j, x_centroids, y_centroids, numCluster,
+                                    sumX, sumY, countPoints);
+    }
+    return changed;
+}
+
+// AVX-512: 16 punti per passo. Come in assignAVX512 ogni lane ha le proprie somme per cluster
+// (indice id * 16 + lane), aggiornate con gather e scatter e ridotte e azzerate alla fine del blocco
+KMEANS_TARGET("avx512f")
+inline bool blockAVX512Float(const float *x_values, const float *y_values, int *points_id,
+                             std::size_t begin, std::size_t end,
+                             const float *x_centroids, const float *y_centroids, int numCluster,
+                             float *sumX, float *sumY, int *countPoints, float *laneSums, int *laneCount) {
+    bool changed = false;
+    float *laneX = laneSums;
+    float *laneY = laneX + numCluster * 16;
+    const __m512i laneOffset = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i one = _mm512_set1_epi32(1);
+
+    std::size_t j = begin;
+    for (; j + 16 <= end; j += 16) {
+        __m512 px = _mm512_loadu_ps(x_values + j);
+        __m512 py = _mm512_loadu_ps(y_values + j);
+        __m512 best = _mm512_set1_ps(INFINITY);
+        __m512 bestIdx = _mm512_setzero_ps();
+
+        for (int k = 0; k < numCluster; k++) {
+            __m512 dx = _mm512_sub_ps(_mm512_set1_ps(x_centroids[k]), px);
+            __m512 dy = _mm512_sub_ps(_mm512_set1_ps(y_centroids[k]), py);
+            __m512 d = _mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy));
+            __mmask16 lt = _mm512_cmp_ps_mask(d, best, _CMP_LT_OQ);
+            best = _mm512_mask_blend_ps(lt, best, d);
+            bestIdx = _mm512_mask_blend_ps(lt, bestIdx, _mm512_set1_ps(k));
+        }
+
+        __m512i ids = _mm512_cvtps_epi32(bestIdx);
+        __m512i old = _mm512_loadu_si512(points_id + j);
+        changed |= _mm512_cmpeq_epi32_mask(ids, old) != 0xFFFF;
+        _mm512_storeu_si512(points_id + j, ids);
+
+        __m512i slot = _mm512_add_epi32(_mm512_slli_epi32(ids, 4), laneOffset);
+        _mm512_i32scatter_ps(laneX, slot, _mm512_add_ps(_mm512_i32gather_ps(slot, laneX, 4), px), 4);
+        _mm512_i32scatter_ps(laneY, slot, _mm512_add_ps(_mm512_i32gather_ps(slot, laneY, 4), py), 4);
+        _mm512_i32scatter_epi32(laneCount, slot,
+                                _mm512_add_epi32(_mm512_i32gather_epi32(slot, laneCount, 4), one), 4);
+    }
+    for (int k = 0; k < numCluster; k++) {
+        for (int l = 0; l < 16; l++) {
+            sumX[k] += laneX[k * 16 + l];
+            sumY[k] += laneY[k * 16 + l];
+            countPoints[k] += laneCount[k * 16 + l];
+            laneX[k * 16 + l] = 0;
+            laneY[k * 16 + l] = 0;
+            laneCount[k * 16 + l] = 0;
+        }
+    }
+    for (; j < end; j++) {
+        changed |= assignPointFloat(x_values, y_values, points_id, j, x_centroids, y_centroids, numCluster,
+                                    sumX, sumY, countPoints);
+    }
+    return changed;
+}
+
+#endif // KMEANS_X86
+
+// Stessa scelta di selectAssignKernel, per i kernel float
+inline assignKernelFloat selectAssignKernelFloat(const char **name) {
+#if defined(KMEANS_X86) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        *name = "AVX-512 float";
+        return assignCompensated<blockAVX512Float, 16>;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        *name = "AVX2 float";
+        return assignCompensated<blockAVX2Float>;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        *name = "SSE2 float";
+        return assignCompensated<blockSSE2Float>;
+    }
+#elif defined(KMEANS_X86) && defined(_MSC_VER)
+    if (cpuHasFeature(7, 1, 16, 0xE6)) {
+        *name = "AVX-512 float";
+        return assignCompensated<blockAVX512Float, 16>;
+    }
+    if (cpuHasFeature(7, 1, 5, 0x6)) {
+        *name = "AVX2 float";
+        return assignCompensated<blockAVX2Float>;
+    }
+    if (cpuHasFeature(1, 3, 26, 0)) {
+        *name = "SSE2 float";
+        return assignCompensated<blockSSE2Float>;
+    }
+#endif
+    *name = "scalare float";
+    return assignCompensated<blockScalarFloat>;
+}
+
+#endif // KMEANS_SOA_KERNEL_FLOAT_H
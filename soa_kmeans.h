@@ -0,0 +1,282 @@
+//
+// K-means sul layout SoA (colonne x e y separate): versione sequenziale e versione OpenMP a blocchi
+// statici, in double con i kernel di soa_kernel.h e in float con quelli di soa_kernel_float.h.
+// Usate dai programmi SoA con grafica e dal benchmark.
+//
+// Nelle versioni double refreshPeriod sceglie come si aggiornano le somme dei cluster: con 0 vengono
+// ricalcolate da zero a ogni iterazione; con n > 0 ricevono solo i punti che cambiano cluster (tolti dal
+// vecchio, aggiunti al nuovo) e vengono ricalcolate da zero ogni n iterazioni, così l'errore di
+// arrotondamento delle sottrazioni resta limitato. Nelle ultime iterazioni cambiano cluster pochi punti
+// e l'aggiornamento costa quasi nulla.
+//
+
+#ifndef KMEANS_SOA_KMEANS_H
+#define KMEANS_SOA_KMEANS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <tuple>
+#include <vector>
+#include <omp.h>
+#include "soa_kernel.h"
+#include "soa_kernel_float.h"
+
+inline std::tuple<std::vector<double>, std::vector<double>, std::vector<int>>
+kmeanSoA(std::vector<double> &x_centroids, std::vector<double> &y_centroids,
+         std::span<const double> x_values, std::span<const double> y_values,
+         int numCluster, int maxIter, int *iterations = nullptr, int refreshPeriod = 0) {
+    std::vector<int> points_id(x_values.size(), -1);
+    std::vector<double> totalX(numCluster, 0);
+    std::vector<double> totalY(numCluster, 0);
+    std::vector<int> countPoints(numCluster, 0);
+    std::vector<double> laneScratch(assignScratchSize(numCluster), 0.0);
+
+    bool centerUpdated;
+    int i = 0;
+
+    // Il kernel SIMD viene scelto una sola volta in base alla CPU
+    const char *kernelName;
+    assignKernel assign = selectAssignKernel(&kernelName);
+    assignKernel assignDelta = selectAssignKernel(&kernelName, true);
+    std::cout << "[SoA] Kernel di assegnazione: " << kernelName << std::endl;
+
+    do {
+        if (i % 10 == 0)
+            std::cout << "[SoA] Numero iterazioni k-means: " << i << std::endl;
+        i++;
+
+        bool full = refreshPeriod <= 0 || (i - 1) % refreshPeriod == 0;
+        if (full) {
+            // Reset dei metadati del passo precedente
+            totalX.assign(numCluster, 0);
+            totalY.assign(numCluster, 0);
+            countPoints.assign(numCluster, 0);
+        }
+
+        // Se nessun punto cambia cluster allora termino
+        centerUpdated = (full ? assign : assignDelta)(x_values.data(), y_values.data(), points_id.data(), 0,
+                                                      x_values.size(), x_centroids.data(), y_centroids.data(),
+                                                      numCluster, totalX.data(), totalY.data(),
+                                                      countPoints.data(), laneScratch.data());
+
+        if (centerUpdated) {
+            for (int w = 0; w < numCluster; ++w) {
+                if (countPoints[w] > 0) {
+                    x_centroids[w] = totalX[w] / countPoints[w];
+                    y_centroids[w] = totalY[w] / countPoints[w];
+                } else {
+                    // Se non ci sono punti assegnati al cluster, mantieni il centroide invariato
+                }
+            }
+        }
+    } while (centerUpdated && i <= maxIter);
+
+    if (iterations) {
+        *iterations = i;
+    }
+    return std::make_tuple(x_centroids, y_centroids, points_id);
+}
+
+// Confini dei blocchi statici di punti. Ogni confine interno cade su un multiplo di 16 punti
+// a partire dalla prima linea di cache di points_id, così due thread non scrivono mai sulla
+// stessa linea di points_id
+inline std::vector<std::size_t> chunkBounds(const std::vector<int> &points_id, int numChunks) {
+    const std::size_t pointsPerLine = 64 / sizeof(int);
+    std::size_t n = points_id.size();
+    std::size_t head = ((64 - reinterpret_cast<std::uintptr_t>(points_id.data()) % 64) % 64) / sizeof(int);
+
+    std::vector<std::size_t> bounds(numChunks + 1);
+    bounds[0] = 0;
+    for (int c = 1; c < numChunks; c++) {
+        std::size_t b = c * n / numChunks;
+        b = b <= head ? head : head + (b - head) / pointsPerLine * pointsPerLine;
+        bounds[c] = std::min(b, n);
+    }
+    bounds[numChunks] = n;
+    return bounds;
+}
+
+inline std::tuple<std::vector<double>, std::vector<double>, std::vector<int>>
+kmeanSoAParallel(std::vector<double> &x_centroids, std::vector<double> &y_centroids,
+                 std::span<const double> x_values, std::span<const double> y_values,
+                 int numCluster, int maxIter, int *iterations = nullptr, int refreshPeriod = 0) {
+    std::vector<int> points_id(x_values.size(), -1);
+    std::vector<double> totalX(numCluster, 0);
+    std::vector<double> totalY(numCluster, 0);
+    std::vector<int> countPoints(numCluster, 0);
+
+    // Accumulatori locali: un blocco per thread, separato dal successivo da almeno una linea
+    // di cache vuota, così i thread non si contendono mai la stessa linea (false sharing)
+    int numThreads = omp_get_max_threads();
+    int strideSums = (numCluster + 7) / 8 * 8 + 8;
+    int strideCount = (numCluster + 15) / 16 * 16 + 16;
+    std::vector<double> localX(numThreads * strideSums);
+    std::vector<double> localY(numThreads * strideSums);
+    std::vector<int> localCount(numThreads * strideCount);
+    // Buffer delle lane del kernel AVX-512, uno per thread con la stessa spaziatura
+    std::size_t strideScratch = (assignScratchSize(numCluster) + 7) / 8 * 8 + 8;
+    std::vector<double> laneScratch(numThreads * strideScratch, 0.0);
+
+    std::vector<std::size_t> bounds = chunkBounds(points_id, numThreads);
+
+    bool centerUpdated;
+    int i = 0;
+
+    // Il kernel SIMD viene scelto una sola volta in base alla CPU
+    const char *kernelName;
+    assignKernel assign = selectAssignKernel(&kernelName);
+    assignKernel assignDelta = selectAssignKernel(&kernelName, true);
+    std::cout << "[SoA-Par] Kernel di assegnazione: " << kernelName << std::endl;
+
+    do {
+        if (i % 10 == 0)
+            std::cout << "[SoA-Par] Numero iterazioni k-means: " << i << std::endl;
+        i++;
+
+        centerUpdated = false;
+        // Gli accumulatori dei thread partono sempre da zero: con la variante delta contengono solo
+        // le variazioni dell'iterazione, che vengono poi sommate alle somme globali
+        bool full = refreshPeriod <= 0 || (i - 1) % refreshPeriod == 0;
+        assignKernel kernel = full ? assign : assignDelta;
+
+#pragma omp parallel num_threads(numThreads) reduction(||:centerUpdated)
+        {
+            int t = omp_get_thread_num();
+            double *sumX = &localX[t * strideSums];
+            double *sumY = &localY[t * strideSums];
+            int *count = &localCount[t * strideCount];
+
+            // Reset dei metadati del passo precedente
+            std::fill(sumX, sumX + numCluster, 0.0);
+            std::fill(sumY, sumY + numCluster, 0.0);
+            std::fill(count, count + numCluster, 0);
+
+            // Se l'ambiente concede meno thread del previsto, i blocchi rimasti vengono ripartiti
+            for (int c = t; c < numThreads; c += omp_get_num_threads()) {
+                centerUpdated = kernel(x_values.data(), y_values.data(), points_id.data(), bounds[c], bounds[c + 1],
+                                       x_centroids.data(), y_centroids.data(), numCluster,
+                                       sumX, sumY, count, &laneScratch[t * strideScratch]) || centerUpdated;
+            }
+        }
+
+        // Somma degli accumulatori dei thread
+        if (full) {
+            totalX.assign(numCluster, 0);
+            totalY.assign(numCluster, 0);
+            countPoints.assign(numCluster, 0);
+        }
+        for (int t = 0; t < numThreads; t++) {
+            for (int w = 0; w < numCluster; ++w) {
+                totalX[w] += localX[t * strideSums + w];
+                totalY[w] += localY[t * strideSums + w];
+                countPoints[w] += localCount[t * strideCount + w];
+            }
+        }
+
+        if (centerUpdated) {
+            for (int w = 0; w < numCluster; ++w) {
+                if (countPoints[w] > 0) {
+                    x_centroids[w] = totalX[w] / countPoints[w];
+                    y_centroids[w] = totalY[w] / countPoints[w];
+                } else {
+                    // Se non ci sono punti assegnati al cluster, mantieni il centroide invariato
+                }
+            }
+        }
+    } while (centerUpdated && i <= maxIter);
+
+    if (iterations) {
+        *iterations = i;
+    }
+    return std::make_tuple(x_centroids, y_centroids, points_id);
+}
+
+// Come kmean, con punti e centroidi float per l'assegnazione. Ogni thread accumula con somme di Kahan,
+// poi le somme dei thread vengono unite in double: i centroidi restituiti sono double
+inline std::tuple<std::vector<double>, std::vector<double>, std::vector<int>>
+kmeanSoAParallelFloat(std::vector<double> &x_centroids, std::vector<double> &y_centroids,
+                      std::span<const float> x_values, std::span<const float> y_values,
+                      int numCluster, int maxIter, int *iterations = nullptr) {
+    std::vector<int> points_id(x_values.size(), -1);
+    std::vector<float> x_current(numCluster);
+    std::vector<float> y_current(numCluster);
+    std::vector<double> totalX(numCluster, 0);
+    std::vector<double> totalY(numCluster, 0);
+    std::vector<int> countPoints(numCluster, 0);
+
+    // Una linea di cache contiene 8 kahanSum
+    int numThreads = omp_get_max_threads();
+    int strideSums = (numCluster + 7) / 8 * 8 + 8;
+    int strideCount = (numCluster + 15) / 16 * 16 + 16;
+    std::vector<kahanSum> localX(numThreads * strideSums);
+    std::vector<kahanSum> localY(numThreads * strideSums);
+    std::vector<int> localCount(numThreads * strideCount);
+
+    std::vector<std::size_t> bounds = chunkBounds(points_id, numThreads);
+
+    bool centerUpdated;
+    int i = 0;
+
+    const char *kernelName;
+    assignKernelFloat assign = selectAssignKernelFloat(&kernelName);
+    std::cout << "[SoA-Par] Kernel di assegnazione: " << kernelName << std::endl;
+
+    do {
+        if (i % 10 == 0)
+            std::cout << "[SoA-Par] Numero iterazioni k-means: " << i << std::endl;
+        i++;
+
+        centerUpdated = false;
+        for (int w = 0; w < numCluster; ++w) {
+            x_current[w] = static_cast<float>(x_centroids[w]);
+            y_current[w] = static_cast<float>(y_centroids[w]);
+        }
+
+#pragma omp parallel num_threads(numThreads) reduction(||:centerUpdated)
+        {
+            int t = omp_get_thread_num();
+            kahanSum *sumX = &localX[t * strideSums];
+            kahanSum *sumY = &localY[t * strideSums];
+            int *count = &localCount[t * strideCount];
+
+            std::fill(sumX, sumX + numCluster, kahanSum{});
+            std::fill(sumY, sumY + numCluster, kahanSum{});
+            std::fill(count, count + numCluster, 0);
+
+            for (int c = t; c < numThreads; c += omp_get_num_threads()) {
+                centerUpdated = assign(x_values.data(), y_values.data(), points_id.data(), bounds[c], bounds[c + 1],
+                                       x_current.data(), y_current.data(), numCluster,
+                                       sumX, sumY, count) || centerUpdated;
+            }
+        }
+
+        totalX.assign(numCluster, 0);
+        totalY.assign(numCluster, 0);
+        countPoints.assign(numCluster, 0);
+        for (int t = 0; t < numThreads; t++) {
+            for (int w = 0; w < numCluster; ++w) {
+                totalX[w] += localX[t * strideSums + w].value();
+                totalY[w] += localY[t * strideSums + w].value();
+                countPoints[w] += localCount[t * strideCount + w];
+            }
+        }
+
+        if (centerUpdated) {
+            for (int w = 0; w < numCluster; ++w) {
+                if (countPoints[w] > 0) {
+                    x_centroids[w] = totalX[w] / countPoints[w];
+                    y_centroids[w] = totalY[w] / countPoints[w];
+                }
+            }
+        }
+    } while (centerUpdated && i <= maxIter);
+
+    if (iterations) {
+        *iterations = i;
+    }
+    return std::make_tuple(x_centroids, y_centroids, points_id);
+}
+
+#endif // KMEANS_SOA_KMEANS_H
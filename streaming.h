@@ -0,0 +1,196 @@
+//
+// K-means in streaming: i punti arrivano uno alla volta (ad esempio da stdin) e ogni punto aggiorna
+// subito il centroide più vicino, con le somme e i conteggi di cluster: il nuovo centroide è la media
+// dei punti assegnati, quindi un punto costa K distanze e un aggiornamento O(1).
+// I centroidi iniziali vengono da k-means++ sui primi punti dello stream, tenuti da parte finché non
+// sono abbastanza; poi anche quei punti vengono aggiunti normalmente.
+// Con una finestra i punti più vecchi scadono: vengono tolti dalle somme del cluster a cui erano stati
+// aggiunti e i centroidi seguono solo i dati recenti. La finestra è un buffer circolare di dimensione
+// fissa, quindi la memoria resta limitata qualunque sia la durata dello stream.
+//
+
+#ifndef KMEANS_STREAMING_H
+#define KMEANS_STREAMING_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "kmeans.h"
+#include "seeding.h"
+
+enum class windowKind {
+    none,   // tutti i punti visti contribuiscono ai centroidi
+    count,  // solo gli ultimi points punti
+    time    // solo i punti arrivati negli ultimi seconds secondi (al massimo maxPoints)
+};
+
+struct streamWindow {
+    windowKind kind = windowKind::none;
+    std::size_t points = 0;
+    double seconds = 0;
+    std::size_t maxPoints = 1 << 20; // limite della memoria per la finestra temporale
+};
+
+class streamingKmeans {
+
+private:
+    static const int countLimit = 1 << 30;
+
+    struct entry {
+        double x;
+        double y;
+        int clusterID;
+        double time;
+    };
+
+    std::vector<cluster> clusters;
+    int numCluster;
+    std::size_t seedingPoints;     // punti raccolti prima di scegliere i centroidi iniziali
+    unsigned long long seed;
+    std::vector<entry> pending;    // punti in attesa della scelta dei centroidi
+    bool seeded = false;
+    streamWindow window;
+    std::vector<entry> ring;       // punti nella finestra, dal più vecchio (head) al più recente
+    std::size_t head = 0;
+    std::size_t size = 0;
+    std::size_t expired = 0;       // punti scaduti dall'ultimo ricalcolo delle somme
+
+    void expireOldest() {
+        const entry &e = ring[head];
+        clusters[e.clusterID].addTotals(-e.x, -e.y, -1);
+        clusters[e.clusterID].updateCentroid();
+        head = (head + 1) % ring.size();
+        size--;
+        // Aggiungere e togliere gli stessi valori lascia errori di arrotondamento nelle somme:
+        // ogni ring.size() punti scaduti le somme vengono ricalcolate dai punti della finestra
+        if (++expired >= ring.size()) {
+            recomputeTotals();
+        }
+    }
+
+    void recomputeTotals() {
+        std::vector<double> totalX(numCluster, 0), totalY(numCluster, 0);
+        std::vector<int> count(numCluster, 0);
+        for (std::size_t i = 0; i < size; i++) {
+            const entry &e = ring[(head + i) % ring.size()];
+            totalX[e.clusterID] += e.x;
+            totalY[e.clusterID] += e.y;
+            count[e.clusterID]++;
+        }
+        for (int c = 0; c < numCluster; c++) {
+            clusters[c].setTotals(totalX[c], totalY[c], count[c]);
+        }
+        expired = 0;
+    }
+
+    // Assegna il punto al centroide più vicino e aggiorna le somme della finestra
+    int insert(double x, double y, double now) {
+        expire(now);
+        if (!ring.empty() && size == ring.size()) {
+            expireOldest();
+        }
+
+        int best = 0;
+        double minDist = INFINITY;
+        for (int c = 0; c < numCluster; c++) {
+            point centroid = clusters[c].getCentroid();
+            double dist = (centroid.x - x) * (centroid.x - x) + (centroid.y - y) * (centroid.y - y);
+            if (dist < minDist) {
+                minDist = dist;
+                best = c;
+            }
+        }
+        clusters[best].addTotals(x, y, 1);
+        clusters[best].updateCentroid();
+        // Senza finestra il conteggio di un cluster cresce senza limite: prima che superi il massimo di un int
+        // somme e conteggio vengono dimezzati, la media (il centroide) non cambia
+        if (ring.empty() && clusters[best].getCount() >= countLimit) {
+            point centroid = clusters[best].getCentroid();
+            int half = countLimit / 2;
+            clusters[best].setTotals(centroid.x * half, centroid.y * half, half);
+        }
+
+        if (!ring.empty()) {
+            ring[(head + size) % ring.size()] = entry{x, y, best, now};
+            size++;
+        }
+        return best;
+    }
+
+public:
+
+    // seedingPoints vale 0 per 100 punti per cluster
+    streamingKmeans(int numCluster, const streamWindow &window, std::size_t seedingPoints = 0,
+                    unsigned long long seed = 1)
+            : clusters(numCluster), numCluster(numCluster),
+              seedingPoints(seedingPoints > 0 ? seedingPoints : static_cast<std::size_t>(numCluster) * 100),
+              seed(seed), window(window) {
+        if (window.kind == windowKind::count) {
+            ring.resize(std::max<std::size_t>(window.points, 1));
+        } else if (window.kind == windowKind::time) {
+            ring.resize(std::max<std::size_t>(window.maxPoints, 1));
+        }
+    }
+
+    // Aggiunge un punto arrivato all'istante now (in secondi). Ritorna il cluster a cui è stato assegnato,
+    // -1 se il punto è stato tenuto da parte per la scelta dei centroidi iniziali
+    int add(double x, double y, double now) {
+        if (seeded) {
+            return insert(x, y, now);
+        }
+        pending.push_back(entry{x, y, -1, now});
+        if (pending.size() >= seedingPoints) {
+            flush();
+        }
+        return -1;
+    }
+
+    // Con la finestra temporale toglie i punti arrivati più di window.seconds secondi prima di now.
+    // Viene chiamata a ogni punto e va chiamata anche prima di leggere i centroidi: se non arrivano punti
+    // la finestra avanza comunque con il tempo
+    void expire(double now) {
+        if (window.kind != windowKind::time) {
+            return;
+        }
+        while (size > 0 && now - ring[head].time > window.seconds) {
+            expireOldest();
+        }
+    }
+
+    // Sceglie i centroidi iniziali con i punti raccolti finora, anche se sono meno di quelli previsti
+    // (ad esempio quando lo stream finisce presto), e li aggiunge
+    void flush() {
+        if (seeded || pending.empty()) {
+            return;
+        }
+        std::vector<point> points;
+        for (const entry &e: pending) {
+            points.push_back(point{e.x, e.y, -1});
+        }
+        std::vector<point> seeds = seedKmeansPlusPlus(points, numCluster, seed);
+        for (int c = 0; c < numCluster; c++) {
+            clusters[c].createCentroid(seeds[c]);
+        }
+        seeded = true;
+        for (const entry &e: pending) {
+            insert(e.x, e.y, e.time);
+        }
+        pending = std::vector<entry>();
+    }
+
+    // Punti che contribuiscono ora ai centroidi (tutti quelli visti se non c'è finestra)
+    long long windowPoints() {
+        long long total = 0;
+        for (auto &c: clusters) {
+            total += c.getCount();
+        }
+        return total;
+    }
+
+    std::vector<cluster> &getClusters() {
+        return clusters;
+    }
+};
+
+#endif // KMEANS_STREAMING_H
@@ -0,0 +1,167 @@
+//
+// Versione SoA parallela: il kernel SIMD di soa_kernel.h viene eseguito su blocchi statici
+// di punti, uno per thread, con accumulatori locali al thread.
+//
+
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <SFML/Graphics.hpp>
+#include <omp.h>
+#include <chrono>
+#include <tuple>
+#include <cstdint>
+#include <algorithm>
+#include <span>
+#include "soa_kmeans.h"
+#include "dataset_binary.h"
+#include "dataset_parser.h"
+#include "model.h"
+#include "renderer.h"
+
+
+std::pair<std::vector<double>, std::vector<double>> extractDataset() {
+
+    std::vector<double> x_vec;
+    std::vector<double> y_vec;
+
+    if (!parseDatasetSoA("../dataset/dataset.txt", x_vec, y_vec)) {
+        std::cerr << "[SoA-Par] Errore nell'apertura del file" << std::endl;
+    }
+    return {std::move(x_vec), std::move(y_vec)};
+}
+
+std::pair<std::vector<double>, std::vector<double>> extractCentroids() {
+    std::vector<double> x_vec;
+    std::vector<double> y_vec;
+
+    std::ifstream inFile("../dataset/centroids.txt");
+
+    if (!inFile) {
+        std::cerr << "[SoA-Par] Errore nell'apertura del file dei centroidi" << std::endl;
+        return {x_vec, y_vec};
+    }
+
+    std::string line;
+    double x, y;
+    while (std::getline(inFile, line)) {
+        std::istringstream iss(line);
+        iss >> x >> y; // Assegno a x e y i valori da file
+        x_vec.push_back(x);
+        y_vec.push_back(y);
+    }
+
+    inFile.close();
+    return {x_vec, y_vec};
+}
+
+// Copia una colonna cambiando precisione, una volta sola prima di k-means
+template<typename Src, typename Dst>
+void convertColumn(std::span<const Src> src, std::vector<Dst> &dst) {
+    dst.resize(src.size());
+#pragma omp parallel for schedule(static)
+    for (std::size_t j = 0; j < src.size(); j++) {
+        dst[j] = static_cast<Dst>(src[j]);
+    }
+}
+
+template<typename T>
+void drawPoints(sf::RenderWindow &window, std::vector<double> &x_centroids,
+                std::vector<double> &y_centroids,
+                std::span<const T> x_values,
+                std::span<const T> y_values, std::vector<int> &points_id) {
+    clusterRenderer renderer("[SoA-Par]", window.getSize());
+    renderer.setPoints(x_values, y_values, points_id);
+    renderer.setCentroids(x_centroids, y_centroids);
+    renderer.run(window);
+}
+
+
+int main() {
+    std::cout << "[SoA-Par] Versione SoA parallela kmeans\n" << std::endl;
+
+    // Controllo del funzionamento di openMP
+#ifdef _OPENMP
+    std::cout << "[SoA-Par] _OPENMP defined" << std::endl;
+    std::cout << "[SoA-Par] Num processors (Phys+HT): " << omp_get_num_procs() << "\n" << std::endl;
+#endif
+
+    int threadNum = 8;
+    omp_set_num_threads(threadNum);
+    std::cout << "[SoA-Par] Thread in uso: " << threadNum << std::endl;
+
+    int numCluster = 10;
+    int maxIter = 150;
+    bool singlePrecision = false; // true: punti e centroidi float, metà dei byte letti per iterazione
+    std::string modelPath = "../dataset/model.kmm"; // vuoto: il modello per predict non viene salvato
+
+    // Se il dataset binario è aggiornato viene mappato in memoria e usato senza copie,
+    // altrimenti si legge il file di testo
+    std::chrono::steady_clock::time_point load_start = std::chrono::steady_clock::now();
+    mappedDataset binaryDataset;
+    bool binary = binaryDatasetIsCurrent("../dataset/dataset.bin", "../dataset/dataset.txt") &&
+                  binaryDataset.open("../dataset/dataset.bin") && binaryDataset.dimension() == 2;
+    std::vector<double> x_text, y_text;
+    std::vector<float> x_single, y_single;
+    std::span<const double> x_values, y_values;
+    std::span<const float> x_float, y_float;
+    if (binary && binaryDataset.type() == datasetFloat64) {
+        x_values = binaryDataset.column(0);
+        y_values = binaryDataset.column(1);
+        std::cout << "[SoA-Par] Dataset binario mappato in memoria" << std::endl;
+    } else if (binary && binaryDataset.type() == datasetFloat32) {
+        x_float = binaryDataset.column<float>(0);
+        y_float = binaryDataset.column<float>(1);
+        std::cout << "[SoA-Par] Dataset binario float mappato in memoria" << std::endl;
+    } else {
+        std::tie(x_text, y_text) = extractDataset();
+        x_values = x_text;
+        y_values = y_text;
+    }
+
+    // Se il file non è nella precisione richiesta le colonne vengono convertite
+    if (singlePrecision && x_float.empty()) {
+        convertColumn(x_values, x_single);
+        convertColumn(y_values, y_single);
+        x_float = x_single;
+        y_float = y_single;
+    } else if (!singlePrecision && x_values.empty()) {
+        convertColumn(x_float, x_text);
+        convertColumn(y_float, y_text);
+        x_values = x_text;
+        y_values = y_text;
+    }
+    std::size_t numPoints = singlePrecision ? x_float.size() : x_values.size();
+    std::chrono::duration<double> load_seconds = std::chrono::steady_clock::now() - load_start;
+    std::cout << "[SoA-Par] Punti caricati: " << numPoints << " in " << load_seconds.count() << " secondi"
+              << (singlePrecision ? " (float)" : "") << std::endl;
+
+    auto [x_centroids, y_centroids] = extractCentroids();
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    int iterations = 0;
+    auto [x_centroids_new, y_centroids_new, points_id] =
+            singlePrecision ? kmeanSoAParallelFloat(x_centroids, y_centroids, x_float, y_float, numCluster, maxIter,
+                                                    &iterations)
+                            : kmeanSoAParallel(x_centroids, y_centroids, x_values, y_values, numCluster, maxIter,
+                                               &iterations);
+
+    std::chrono::steady_clock::time_point end_time = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed_seconds = end_time - start_time;
+    std::cout << "[SoA-Par] Tempo impiegato da k-means: " << elapsed_seconds.count() << " secondi" << std::endl;
+
+    if (!modelPath.empty() &&
+        writeModel(modelPath, makeModel(x_centroids_new, y_centroids_new, "soa-parallel", numPoints, iterations))) {
+        std::cout << "[SoA-Par] Modello salvato in " << modelPath << std::endl;
+    }
+
+    sf::RenderWindow window(sf::VideoMode(1600, 1200), "SoA parallel clusters");
+    if (x_values.empty()) {
+        drawPoints(window, x_centroids, y_centroids, x_float, y_float, points_id);
+    } else {
+        drawPoints(window, x_centroids, y_centroids, x_values, y_values, points_id);
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+//
+// Telemetria per iterazione delle versioni di Lloyd: tempi delle fasi, punti spostati, inerzia (SSE),
+// spostamento massimo dei centroidi e sbilanciamento tra i thread. Una riga per iterazione, in JSON
+// (una riga JSON per iterazione) o in CSV se il file termina in ".csv".
+// Le funzioni di k-means ricevono un telemetryLog * che vale nullptr quando la telemetria è spenta:
+// in quel caso non misurano nulla e i cicli sui punti restano quelli di sempre.
+//
+
+#ifndef KMEANS_TELEMETRY_H
+#define KMEANS_TELEMETRY_H
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct iterationStats {
+    int iteration = 0;
+    double resetSeconds = 0;   // copia dei centroidi, avvio dei thread e azzeramento delle somme
+    double assignSeconds = 0;  // assegnazione dei punti (con più thread: fino all'arrivo dell'ultimo)
+    double reduceSeconds = 0;  // unione delle somme parziali dei thread
+    double updateSeconds = 0;  // calcolo dei nuovi centroidi
+    long long moved = 0;       // punti che hanno cambiato cluster
+    double inertia = 0;        // somma delle distanze al quadrato dai centroidi usati nell'assegnazione
+    double maxShift = 0;       // spostamento massimo di un centroide nell'aggiornamento
+    double threadMin = 0;      // tempo di assegnazione del thread più veloce
+    double threadMax = 0;      // e del più lento
+    double imbalance = 1;      // tempo massimo / tempo medio dei thread (1: carico perfettamente bilanciato)
+};
+
+class telemetryLog {
+
+private:
+    std::ofstream outFile;
+    bool csv = false;
+    std::string run;
+
+public:
+
+    // Apre path in aggiunta, così più esecuzioni finiscono nello stesso file. Ritorna false in caso di errore
+    bool open(const std::string &path) {
+        csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+        std::error_code ec;
+        bool empty = std::filesystem::file_size(path, ec) == 0 || ec;
+        outFile.open(path, std::ios::app);
+        if (outFile && csv && empty) {
+            outFile << "run,iteration,reset_s,assign_s,reduce_s,update_s,moved,inertia,max_shift,"
+                       "thread_min_s,thread_max_s,imbalance\n";
+        }
+        return static_cast<bool>(outFile);
+    }
+
+    // Nome dell'esecuzione scritto in ogni riga (ad esempio backend e numero di thread)
+    void setRun(const std::string &name) {
+        run = name;
+    }
+
+    void write(const iterationStats &s) {
+        if (csv) {
+            outFile << run << "," << s.iteration << "," << s.resetSeconds << "," << s.assignSeconds << ","
+                    << s.reduceSeconds << "," << s.updateSeconds << "," << s.moved << "," << s.inertia << ","
+                    << s.maxShift << "," << s.threadMin << "," << s.threadMax << "," << s.imbalance << "\n";
+        } else {
+            outFile << "{\"run\": \"" << run << "\", \"iteration\": " << s.iteration
+                    << ", \"reset_s\": " << s.resetSeconds << ", \"assign_s\": " << s.assignSeconds
+                    << ", \"reduce_s\": " << s.reduceSeconds << ", \"update_s\": " << s.updateSeconds
+                    << ", \"moved\": " << s.moved << ", \"inertia\": " << s.inertia
+                    << ", \"max_shift\": " << s.maxShift << ", \"thread_min_s\": " << s.threadMin
+                    << ", \"thread_max_s\": " << s.threadMax << ", \"imbalance\": " << s.imbalance << "}\n";
+        }
+    }
+};
+
+// Tempo minimo, massimo e sbilanciamento a partire dai tempi di assegnazione dei singoli thread
+inline void threadBalance(const std::vector<double> &threadSeconds, int numThreads, iterationStats &s) {
+    double sum = 0;
+    s.threadMin = threadSeconds[0];
+    s.threadMax = threadSeconds[0];
+    for (int t = 0; t < numThreads; t++) {
+        s.threadMin = std::min(s.threadMin, threadSeconds[t]);
+        s.threadMax = std::max(s.threadMax, threadSeconds[t]);
+        sum += threadSeconds[t];
+    }
+    s.imbalance = sum > 0 ? s.threadMax * numThreads / sum : 1;
+}
+
+#endif // KMEANS_TELEMETRY_H
@@ -0,0 +1,252 @@
+//
+// K-means Yinyang: i centroidi vengono divisi in gruppi e per ogni punto si tiene un solo limite
+// inferiore per gruppo, così la memoria resta O(N * K / 10) anche con K nell'ordine delle migliaia.
+//
+
+#ifndef KMEANS_YINYANG_H
+#define KMEANS_YINYANG_H
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "kmeans.h"
+
+// Raggruppa i centroidi con qualche iterazione di k-means sui centroidi stessi.
+// Ritorna la lista dei centroidi di ogni gruppo (senza gruppi vuoti)
+inline std::vector<std::vector<int>> groupCentroids(const std::vector<point> &centroids, int numGroups) {
+    int numClusters = centroids.size();
+    std::vector<point> seeds(numGroups);
+    for (int g = 0; g < numGroups; g++) {
+        seeds[g] = centroids[g * numClusters / numGroups];
+    }
+
+    std::vector<int> groupOf(numClusters, 0);
+    for (int it = 0; it < 5; it++) {
+        std::vector<double> sumX(numGroups, 0), sumY(numGroups, 0);
+        std::vector<int> count(numGroups, 0);
+        for (int c = 0; c < numClusters; c++) {
+            double minDist = INFINITY;
+            for (int g = 0; g < numGroups; g++) {
+                double dist = pointDistance(centroids[c], seeds[g]);
+                if (dist < minDist) {
+                    minDist = dist;
+                    groupOf[c] = g;
+                }
+            }
+            sumX[groupOf[c]] += centroids[c].x;
+            sumY[groupOf[c]] += centroids[c].y;
+            count[groupOf[c]]++;
+        }
+        for (int g = 0; g < numGroups; g++) {
+            if (count[g] > 0) {
+                seeds[g].x = sumX[g] / count[g];
+                seeds[g].y = sumY[g] / count[g];
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> groups(numGroups);
+    for (int c = 0; c < numClusters; c++) {
+        groups[groupOf[c]].push_back(c);
+    }
+    groups.erase(std::remove_if(groups.begin(), groups.end(),
+                                [](const std::vector<int> &g) { return g.empty(); }), groups.end());
+    return groups;
+}
+
+// Per ogni punto: limite superiore alla distanza dal centroide assegnato e, per ogni gruppo,
+// limite inferiore alla distanza dai centroidi del gruppo (escluso quello assegnato).
+// - filtro globale: se upper <= min dei limiti di gruppo il punto non cambia cluster;
+// - filtro di gruppo: si esaminano solo i gruppi con limite < della distanza migliore trovata;
+// - filtro locale: nel gruppo si salta c se (limite del gruppo prima dello spostamento - spostamento
+//   di c) non è inferiore alla distanza migliore.
+// Come in kmeanElkan, skippedDistances riceve per ogni iterazione le distanze non calcolate
+inline std::vector<cluster> kmeanYinyang(std::vector<cluster> &clusters, std::vector<point> &points, int maxIter,
+                                         std::vector<long long> &skippedDistances) {
+    int numClusters = clusters.size();
+    std::size_t numPoints = points.size();
+
+    std::vector<point> centroids(numClusters);
+    for (int c = 0; c < numClusters; c++) {
+        centroids[c] = clusters[c].getCentroid();
+    }
+
+    std::vector<std::vector<int>> groups = groupCentroids(centroids, std::max(1, numClusters / 10));
+    int numGroups = groups.size();
+    std::vector<int> groupOf(numClusters);
+    for (int g = 0; g < numGroups; g++) {
+        for (int c: groups[g]) {
+            groupOf[c] = g;
+        }
+    }
+
+    std::vector<double> upper(numPoints);
+    std::vector<double> lower(numPoints * numGroups);
+    std::vector<char> upperStale(numPoints, 0);
+    std::vector<double> drift(numClusters, 0);
+    std::vector<double> groupDrift(numGroups, 0);
+
+    // Risultati parziali dei gruppi esaminati per il punto corrente
+    std::vector<char> examined(numGroups);
+    std::vector<double> groupMin(numGroups), groupSecond(numGroups), groupBound(numGroups);
+    std::vector<int> groupArgMin(numGroups);
+
+    bool centerUpdated;
+    int i = 0;
+    skippedDistances.clear();
+
+    do {
+        centerUpdated = false;
+        if (i % 10 == 0)
+            std::cout << "[Seq] Numero iterazioni k-means (Yinyang): " << i << std::endl;
+        long long computed = 0;
+
+        for (std::size_t p = 0; p < numPoints; p++) {
+            point &pt = points[p];
+            double *lb = &lower[p * numGroups];
+            int assigned = pt.clusterID;
+
+            if (i == 0) {
+                // Prima iterazione: tutte le distanze, che inizializzano i limiti
+                double minDist = INFINITY;
+                std::fill(groupMin.begin(), groupMin.end(), INFINITY);
+                std::fill(groupSecond.begin(), groupSecond.end(), INFINITY);
+                for (int c = 0; c < numClusters; c++) {
+                    double dist = pointDistance(pt, centroids[c]);
+                    int g = groupOf[c];
+                    if (dist < groupMin[g]) {
+                        groupSecond[g] = groupMin[g];
+                        groupMin[g] = dist;
+                        groupArgMin[g] = c;
+                    } else if (dist < groupSecond[g]) {
+                        groupSecond[g] = dist;
+                    }
+                    if (dist < minDist) {
+                        minDist = dist;
+                        assigned = c;
+                    }
+                }
+                computed += numClusters;
+                upper[p] = minDist;
+                for (int g = 0; g < numGroups; g++) {
+                    lb[g] = groupArgMin[g] == assigned ? groupSecond[g] : groupMin[g];
+                }
+            } else {
+                double globalLower = *std::min_element(lb, lb + numGroups);
+                if (upper[p] <= globalLower) {
+                    continue;
+                }
+                if (upperStale[p]) {
+                    upper[p] = pointDistance(pt, centroids[assigned]);
+                    upperStale[p] = 0;
+                    computed++;
+                    if (upper[p] <= globalLower) {
+                        continue;
+                    }
+                }
+
+                double assignedDist = upper[p];
+                double bestDist = assignedDist;
+                int best = assigned;
+
+                for (int g = 0; g < numGroups; g++) {
+                    examined[g] = lb[g] < bestDist;
+                    if (!examined[g]) {
+                        continue;
+                    }
+                    double lowerBeforeDrift = lb[g] + groupDrift[g];
+                    groupMin[g] = INFINITY;
+                    groupSecond[g] = INFINITY;
+                    groupBound[g] = INFINITY;
+                    groupArgMin[g] = -1;
+                    for (int c: groups[g]) {
+                        double dist;
+                        if (c == assigned) {
+                            dist = assignedDist;
+                        } else if (lowerBeforeDrift - drift[c] >= bestDist) {
+                            // Filtro locale: c non può essere il più vicino, ma resta nel limite del gruppo
+                            groupBound[g] = std::min(groupBound[g], lowerBeforeDrift - drift[c]);
+                            continue;
+                        } else {
+                            dist = pointDistance(pt, centroids[c]);
+                            computed++;
+                        }
+                        if (dist < groupMin[g]) {
+                            groupSecond[g] = groupMin[g];
+                            groupMin[g] = dist;
+                            groupArgMin[g] = c;
+                        } else if (dist < groupSecond[g]) {
+                            groupSecond[g] = dist;
+                        }
+                        if (dist < bestDist) {
+                            bestDist = dist;
+                            best = c;
+                        }
+                    }
+                }
+
+                // Nuovi limiti dei gruppi esaminati, escludendo il centroide assegnato
+                for (int g = 0; g < numGroups; g++) {
+                    if (examined[g]) {
+                        double nearest = groupArgMin[g] == best ? groupSecond[g] : groupMin[g];
+                        lb[g] = std::min(groupBound[g], nearest);
+                    }
+                }
+                // Il vecchio centroide, se non è stato esaminato il suo gruppo, entra nel limite del gruppo
+                if (best != assigned && !examined[groupOf[assigned]]) {
+                    lb[groupOf[assigned]] = std::min(lb[groupOf[assigned]], assignedDist);
+                }
+
+                upper[p] = bestDist;
+                assigned = best;
+            }
+
+            if (pt.clusterID != assigned) {
+                centerUpdated = true; // Se nessun punto cambia cluster allora termino
+            }
+            pt.clusterID = assigned;
+        }
+
+        skippedDistances.push_back(static_cast<long long>(numPoints) * numClusters - computed);
+        i++;
+
+        if (centerUpdated) {
+            // Le somme vengono fatte nello stesso ordine del ciclo di Lloyd, così i centroidi coincidono
+            for (auto &cluster: clusters) {
+                cluster.resetTotalX();
+                cluster.resetTotalY();
+                cluster.resetCountPoints();
+            }
+            for (auto &pt: points) {
+                clusters[pt.clusterID].addTotalX(pt.x);
+                clusters[pt.clusterID].addTotalY(pt.y);
+                clusters[pt.clusterID].countPoints();
+            }
+            std::fill(groupDrift.begin(), groupDrift.end(), 0.0);
+            for (int c = 0; c < numClusters; c++) {
+                clusters[c].updateCentroid();
+                point moved = clusters[c].getCentroid();
+                drift[c] = pointDistance(centroids[c], moved);
+                groupDrift[groupOf[c]] = std::max(groupDrift[groupOf[c]], drift[c]);
+                centroids[c] = moved;
+            }
+
+            // Ogni limite di gruppo scende dello spostamento massimo dei centroidi del gruppo
+            for (std::size_t p = 0; p < numPoints; p++) {
+                double *lb = &lower[p * numGroups];
+                for (int g = 0; g < numGroups; g++) {
+                    lb[g] -= groupDrift[g];
+                }
+                if (drift[points[p].clusterID] > 0) {
+                    upper[p] += drift[points[p].clusterID];
+                    upperStale[p] = 1;
+                }
+            }
+        }
+    } while (centerUpdated && i <= maxIter);
+
+    return clusters;
+}
+
+#endif // KMEANS_YINYANG_H